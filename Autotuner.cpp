@@ -0,0 +1,526 @@
+/**
+ * @file Autotuner.cpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ */
+
+#include "Autotuner.hpp"
+#include "RSA.hpp"
+#include "ChunkedContainer.hpp"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <vector>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <unistd.h>
+#include <sys/stat.h>
+
+namespace {
+
+const int CACHE_VERSION = 2;
+
+// A kalibráció hatványozásainak modulusa, az RSA osztály ábécéjének mérete
+const unsigned long long ALPHABET_MODULUS = 26;
+
+// A darabméret kalibrációjában mért véletlen olvasások száma és hossza
+const size_t RANGE_READS = 16;
+const size_t RANGE_LENGTH = 64;
+
+//! best_time függvény
+/*!
+    \param reps ismétlések száma
+    \param f a mérendő művelet
+    \return a leggyorsabb futás ideje másodpercben
+*/
+template <class F>
+double best_time(int reps, F f) {
+    double best = 0;
+    for (int i = 0; i < reps; ++i) {
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        f();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (i == 0 || elapsed.count() < best)
+            best = elapsed.count();
+    }
+    return best;
+}
+
+//! env függvény
+/*!
+    \return a környezeti változó értéke, vagy üres sztring ha nincs beállítva
+*/
+std::string env(const char* name) {
+    const char* value = std::getenv(name);
+    return value ? value : "";
+}
+
+//! parse_unsigned függvény
+/*!
+    \return igaz, ha a sztring teljes egészében egy nemnegatív egész szám
+*/
+bool parse_unsigned(const std::string& text, unsigned long long& value) {
+    if (text.empty() || text.find_first_not_of("0123456789") != std::string::npos)
+        return false;
+    std::istringstream in(text);
+    in >> value;
+    return !in.fail();
+}
+
+//! hostname függvény
+std::string hostname() {
+    char name[256] = {0};
+    if (gethostname(name, sizeof(name) - 1) != 0 || name[0] == 0)
+        return "unknown";
+    return name;
+}
+
+//! sanitize függvény
+/*!
+    A cache fájl soronkénti formátuma miatt kicseréli a sortöréseket és az '=' jelet.
+*/
+std::string sanitize(std::string text) {
+    for (char& c : text)
+        if (c == '\n' || c == '\r' || c == '=')
+            c = '_';
+    return text;
+}
+
+}
+
+//! defaults függvény
+/*!
+    \return kalibráció nélküli alapértékek: a legszélesebb támogatott kernel,
+    ChunkedContainer::DEFAULT_CHUNK_SIZE, a hardver szálszáma, bitenkénti hatványozás
+    és a legszélesebb támogatott ModExpBatch kernel
+*/
+TuningConfig Autotuner::defaults() {
+    TuningConfig config;
+    config.asciiKernel = Caesar::best_ascii_kernel();
+    config.chunkSize = ChunkedContainer::DEFAULT_CHUNK_SIZE;
+    config.threads = 0;
+    config.modexpWindow = 1;
+    config.modexpKernel = ModExpBatch::best_kernel();
+    return config;
+}
+
+//! calibrate függvény
+/*!
+    \return az ezen a gépen leggyorsabbnak mért beállítások
+
+    1. Minden támogatott ASCII kereső kernelt lemér egy tisztán ASCII pufferen.
+
+    2. Az RSA::power()-t (ezt használja a skalár út: rövid szövegek, decrypt_token())
+    lemér 1..6 bites hatványozási ablakkal, különböző hosszúságú kitevőkkel.
+    A hosszabb szövegek a ModExpBatch kernelein futnak, ezekre nincs hatással az ablak.
+
+    3. Minden támogatott ModExpBatch kernelt lemér egy nagy kötegen.
+
+    4. A darabméretet egy vegyes terhelésen méri: a teljes tároló párhuzamos
+    visszafejtése, plusz RANGE_READS darab RANGE_LENGTH bájtos decrypt_range()
+    olvasás véletlen helyről. A csak áteresztőképességet mérő cél mindig a
+    legnagyobb darabot választaná, ami a véletlen elérést (és az RSA tárolókat)
+    lassítaná. (A darabméretek növekvő sorrendben vannak; ha már az olvasások
+    ideje is rosszabb a legjobb összesnél, a nagyobbakat nem méri.) Ezután a legjobb darabmérettel 1, 2, 4, ... szállal méri a
+    párhuzamos visszafejtést (legfeljebb a hardver szálszámáig).
+
+    A mérés idejére átállítja a globális beállításokat, a végén visszaállítja az eredetieket.
+*/
+TuningConfig Autotuner::calibrate() {
+    TuningConfig saved;
+    saved.asciiKernel = Caesar::ascii_kernel();
+    saved.chunkSize = ChunkedContainer::default_chunk_size();
+    saved.threads = ChunkedContainer::default_threads();
+    saved.modexpWindow = RSA::modexp_window();
+    saved.modexpKernel = ModExpBatch::kernel();
+
+    TuningConfig best = defaults();
+
+    // 1. ASCII kernel
+    std::string ascii(64 * 1024, 'x');
+    double bestTime = -1;
+    const Caesar::AsciiKernel kernels[] = {Caesar::ASCII_SCALAR, Caesar::ASCII_SSE2, Caesar::ASCII_AVX2};
+    for (Caesar::AsciiKernel kernel : kernels) {
+        if (!Caesar::set_ascii_kernel(kernel))
+            continue;
+        volatile size_t sink = 0;
+        double t = best_time(5, [&] {
+            for (int i = 0; i < 64; ++i)
+                sink = sink + Caesar::ascii_prefix(ascii.data() + (i & 7), ascii.size() - (i & 7));
+        });
+        if (bestTime < 0 || t < bestTime) {
+            bestTime = t;
+            best.asciiKernel = kernel;
+        }
+    }
+    Caesar::set_ascii_kernel(best.asciiKernel);
+
+    // 2. Hatványozási ablak
+    RSA rsa;
+    std::vector<unsigned long long> bases(4096), exponents(bases.size()), powers(bases.size());
+    unsigned long long state = 0x9E3779B97F4A7C15ull;
+    for (size_t i = 0; i < bases.size(); ++i) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        bases[i] = i % ALPHABET_MODULUS;
+        exponents[i] = state >> (i % 64);
+    }
+    bestTime = -1;
+    for (unsigned window = 1; window <= 6; ++window) {
+        RSA::set_modexp_window(window);
+        volatile unsigned long long sink = 0;
+        double t = best_time(3, [&] {
+            for (size_t i = 0; i < bases.size(); ++i)
+                sink = sink + rsa.power(bases[i], exponents[i], ALPHABET_MODULUS);
+        });
+        if (bestTime < 0 || t < bestTime) {
+            bestTime = t;
+            best.modexpWindow = window;
+        }
+    }
+
+    // 3. Kötegelt hatványozás kernele
+    bestTime = -1;
+    const ModExpBatch::Kernel batchKernels[] = {ModExpBatch::KERNEL_SCALAR, ModExpBatch::KERNEL_AVX2, ModExpBatch::KERNEL_AVX512};
+    for (ModExpBatch::Kernel kernel : batchKernels) {
+        if (!ModExpBatch::set_kernel(kernel))
+            continue;
+        double t = best_time(3, [&] {
+            ModExpBatch::compute(bases.data(), exponents.data(), ALPHABET_MODULUS, powers.data(), bases.size());
+        });
+        if (bestTime < 0 || t < bestTime) {
+            bestTime = t;
+            best.modexpKernel = kernel;
+        }
+    }
+
+    // 4. Darabméret és szálszám
+    Caesar caesar(3, Caesar::HUNGARIAN_LOWER, Caesar::HUNGARIAN_UPPER);
+    std::string text;
+    while (text.size() < 1024 * 1024)
+        text += "Lement a nap a nagy pusztán, végig rajta alkony pír lepett. ";
+    unsigned hardware = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<size_t> offsets(RANGE_READS);
+    for (size_t& offset : offsets) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        offset = static_cast<size_t>(state % (text.size() - RANGE_LENGTH));
+    }
+    const size_t chunkSizes[] = {1024, 4096, 16384, 65536, 262144};
+    bestTime = -1;
+    for (size_t chunkSize : chunkSizes) {
+        ChunkedContainer container(caesar, chunkSize);
+        std::string sealed = container.encrypt(text);
+        auto readAll = [&] {
+            for (size_t offset : offsets)
+                container.decrypt_range(sealed, offset, RANGE_LENGTH);
+        };
+        // nagyobb darabnál az olvasás csak lassabb lesz, a többit nem érdemes mérni
+        double reads = best_time(1, readAll);
+        if (bestTime >= 0 && reads >= bestTime)
+            break;
+        reads = std::min(reads, best_time(2, readAll));
+        double t = reads + best_time(3, [&] { container.decrypt_parallel(sealed, hardware); });
+        if (bestTime < 0 || t < bestTime) {
+            bestTime = t;
+            best.chunkSize = chunkSize;
+        }
+    }
+    ChunkedContainer container(caesar, best.chunkSize);
+    std::string sealed = container.encrypt(text);
+    bestTime = -1;
+    for (unsigned threads = 1; threads <= hardware; threads *= 2) {
+        double t = best_time(3, [&] { container.decrypt_parallel(sealed, threads); });
+        if (bestTime < 0 || t < bestTime) {
+            bestTime = t;
+            best.threads = threads;
+        }
+    }
+
+    apply(saved);
+    return best;
+}
+
+//! load függvény
+/*!
+    \param path a cache fájl útvonala
+    \param config ide tölti be a beállításokat
+    \return hamis, ha a fájl nem létezik, hibás, más gépen készült, vagy a kernel itt nem futtatható
+*/
+bool Autotuner::load(const std::string& path, TuningConfig& config) {
+    std::ifstream in(path.c_str());
+    if (!in)
+        return false;
+
+    TuningConfig loaded = defaults();
+    bool hostOk = false, versionOk = false;
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t eq = line.find('=');
+        if (eq == std::string::npos)
+            continue;
+        std::string key = line.substr(0, eq);
+        std::string value = line.substr(eq + 1);
+        unsigned long long number = 0;
+        if (key == "version") {
+            versionOk = parse_unsigned(value, number) && number == CACHE_VERSION;
+        } else if (key == "host") {
+            hostOk = value == host_fingerprint();
+        } else if (key == "ascii_kernel") {
+            if (!parse_kernel(value, loaded.asciiKernel) || !Caesar::kernel_supported(loaded.asciiKernel))
+                return false;
+        } else if (key == "chunk_size") {
+            if (!parse_unsigned(value, number) || number == 0)
+                return false;
+            loaded.chunkSize = number;
+        } else if (key == "threads") {
+            if (!parse_unsigned(value, number))
+                return false;
+            loaded.threads = static_cast<unsigned>(number);
+        } else if (key == "modexp_window") {
+            if (!parse_unsigned(value, number) || number < 1 || number > RSA::MAX_MODEXP_WINDOW)
+                return false;
+            loaded.modexpWindow = static_cast<unsigned>(number);
+        } else if (key == "modexp_kernel") {
+            if (!parse_kernel(value, loaded.modexpKernel) || !ModExpBatch::kernel_supported(loaded.modexpKernel))
+                return false;
+        }
+    }
+    if (!hostOk || !versionOk)
+        return false;
+    config = loaded;
+    return true;
+}
+
+//! save függvény
+/*!
+    \param path a cache fájl útvonala
+    \param config a mentendő beállítások
+    \return igaz, ha sikerült a mentés
+    Ugyanabban a könyvtárban egy mkstemp()-pel létrehozott, folyamatonként egyedi
+    ideiglenes fájlba ír, majd átnevezi. Így a párhuzamosan kalibráló folyamatok
+    nem írnak egymás fájljába, és az olvasók sosem látnak félkész fájlt.
+*/
+bool Autotuner::save(const std::string& path, const TuningConfig& config) {
+    std::ostringstream out;
+    out << "version=" << CACHE_VERSION << "\n"
+        << "host=" << host_fingerprint() << "\n"
+        << "ascii_kernel=" << kernel_name(config.asciiKernel) << "\n"
+        << "chunk_size=" << config.chunkSize << "\n"
+        << "threads=" << config.threads << "\n"
+        << "modexp_window=" << config.modexpWindow << "\n"
+        << "modexp_kernel=" << kernel_name(config.modexpKernel) << "\n";
+    std::string data = out.str();
+
+    std::string tmp = path + ".XXXXXX";
+    int fd = mkstemp(&tmp[0]);
+    if (fd < 0)
+        return false;
+    bool ok = fchmod(fd, 0644) == 0;
+    for (size_t written = 0; ok && written < data.size(); ) {
+        ssize_t n = write(fd, data.data() + written, data.size() - written);
+        if (n < 0 && errno == EINTR)
+            continue;
+        ok = n > 0;
+        if (ok)
+            written += static_cast<size_t>(n);
+    }
+    ok = close(fd) == 0 && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+//! apply_env függvény
+/*!
+    \param config a felülírandó beállítások
+    Az ENCRYPTION_ASCII_KERNEL, ENCRYPTION_CHUNK_SIZE, ENCRYPTION_THREADS,
+    ENCRYPTION_MODEXP_WINDOW és ENCRYPTION_MODEXP_KERNEL környezeti változók
+    felülírják a megfelelő értéket.
+    Hibás értéknél figyelmeztet és megtartja az eredetit.
+*/
+void Autotuner::apply_env(TuningConfig& config) {
+    std::string value;
+    unsigned long long number = 0;
+
+    value = env("ENCRYPTION_ASCII_KERNEL");
+    if (!value.empty()) {
+        Caesar::AsciiKernel kernel;
+        if (parse_kernel(value, kernel) && Caesar::kernel_supported(kernel))
+            config.asciiKernel = kernel;
+        else
+            std::cerr << "Hibás vagy nem támogatott ENCRYPTION_ASCII_KERNEL: " << value << std::endl;
+    }
+
+    value = env("ENCRYPTION_CHUNK_SIZE");
+    if (!value.empty()) {
+        if (parse_unsigned(value, number) && number > 0)
+            config.chunkSize = number;
+        else
+            std::cerr << "Hibás ENCRYPTION_CHUNK_SIZE: " << value << std::endl;
+    }
+
+    value = env("ENCRYPTION_THREADS");
+    if (!value.empty()) {
+        if (parse_unsigned(value, number))
+            config.threads = static_cast<unsigned>(number);
+        else
+            std::cerr << "Hibás ENCRYPTION_THREADS: " << value << std::endl;
+    }
+
+    value = env("ENCRYPTION_MODEXP_WINDOW");
+    if (!value.empty()) {
+        if (parse_unsigned(value, number) && number >= 1 && number <= RSA::MAX_MODEXP_WINDOW)
+            config.modexpWindow = static_cast<unsigned>(number);
+        else
+            std::cerr << "Hibás ENCRYPTION_MODEXP_WINDOW: " << value << std::endl;
+    }
+
+    value = env("ENCRYPTION_MODEXP_KERNEL");
+    if (!value.empty()) {
+        ModExpBatch::Kernel kernel;
+        if (parse_kernel(value, kernel) && ModExpBatch::kernel_supported(kernel))
+            config.modexpKernel = kernel;
+        else
+            std::cerr << "Hibás vagy nem támogatott ENCRYPTION_MODEXP_KERNEL: " << value << std::endl;
+    }
+}
+
+//! apply függvény
+/*!
+    \param config az alkalmazandó beállítások
+    Beállítja a Caesar, RSA, ModExpBatch és ChunkedContainer globális alapértékeit.
+*/
+void Autotuner::apply(const TuningConfig& config) {
+    Caesar::set_ascii_kernel(config.asciiKernel);
+    ChunkedContainer::set_default_chunk_size(config.chunkSize);
+    ChunkedContainer::set_default_threads(config.threads);
+    RSA::set_modexp_window(config.modexpWindow);
+    ModExpBatch::set_kernel(config.modexpKernel);
+}
+
+//! initialize függvény
+/*!
+    \param calibrated ha nem NULL, ide kerül, hogy lefutott-e a kalibráció
+    \return az alkalmazott beállítások
+
+    Betölti a cache fájlt; ha az nem használható (vagy ENCRYPTION_RECALIBRATE=1),
+    kalibrál és elmenti az eredményt. Ezután alkalmazza a környezeti változókat
+    (ezek nem kerülnek a cache-be), végül beállítja az értékeket.
+*/
+TuningConfig Autotuner::initialize(bool* calibrated) {
+    std::string path = cache_path();
+    TuningConfig config;
+    bool fromCache = env("ENCRYPTION_RECALIBRATE") != "1" && load(path, config);
+    if (!fromCache) {
+        config = calibrate();
+        save(path, config);
+    }
+    if (calibrated)
+        *calibrated = !fromCache;
+
+    apply_env(config);
+    apply(config);
+    return config;
+}
+
+//! cache_path függvény
+/*!
+    \return a cache fájl útvonala: ENCRYPTION_TUNING_CACHE, különben
+    $XDG_CACHE_HOME vagy $HOME/.cache alatt encryption-tuning-<gépnév>.cfg
+    (a könyvtárat szükség esetén létrehozza), végső esetben az aktuális könyvtárban.
+*/
+std::string Autotuner::cache_path() {
+    std::string path = env("ENCRYPTION_TUNING_CACHE");
+    if (!path.empty())
+        return path;
+
+    std::string dir = env("XDG_CACHE_HOME");
+    if (dir.empty() && !env("HOME").empty())
+        dir = env("HOME") + "/.cache";
+    std::string file = "encryption-tuning-" + sanitize(hostname()) + ".cfg";
+    if (dir.empty())
+        return file;
+    mkdir(dir.c_str(), 0755);
+    return dir + "/" + file;
+}
+
+//! host_fingerprint függvény
+/*!
+    \return a gépet azonosító sztring: gépnév, processzor típusa és a hardver szálszáma
+    Ha ez megváltozik (pl. a cache fájl másik gépre kerül), újra kell kalibrálni.
+*/
+std::string Autotuner::host_fingerprint() {
+    std::string model = "unknown";
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    while (std::getline(cpuinfo, line)) {
+        if (line.compare(0, 10, "model name") == 0) {
+            size_t start = line.find_first_not_of(' ', line.find(':') + 1);
+            if (line.find(':') != std::string::npos && start != std::string::npos)
+                model = line.substr(start);
+            break;
+        }
+    }
+    std::ostringstream out;
+    out << hostname() << "|" << model << "|" << std::thread::hardware_concurrency();
+    return sanitize(out.str());
+}
+
+//! kernel_name függvény
+/*!
+    \return a kernel neve a cache fájlban és a környezeti változóban használt alakban
+*/
+const char* Autotuner::kernel_name(Caesar::AsciiKernel kernel) {
+    switch (kernel) {
+        case Caesar::ASCII_AVX2: return "avx2";
+        case Caesar::ASCII_SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+//! parse_kernel függvény
+/*!
+    \return hamis, ha a név ismeretlen
+*/
+bool Autotuner::parse_kernel(const std::string& name, Caesar::AsciiKernel& kernel) {
+    if (name == "scalar") kernel = Caesar::ASCII_SCALAR;
+    else if (name == "sse2") kernel = Caesar::ASCII_SSE2;
+    else if (name == "avx2") kernel = Caesar::ASCII_AVX2;
+    else return false;
+    return true;
+}
+
+//! kernel_name függvény (ModExpBatch)
+/*!
+    \return a kernel neve a cache fájlban és a környezeti változóban használt alakban
+*/
+const char* Autotuner::kernel_name(ModExpBatch::Kernel kernel) {
+    switch (kernel) {
+        case ModExpBatch::KERNEL_AVX512: return "avx512";
+        case ModExpBatch::KERNEL_AVX2: return "avx2";
+        default: return "scalar";
+    }
+}
+
+//! parse_kernel függvény (ModExpBatch)
+/*!
+    \return hamis, ha a név ismeretlen
+*/
+bool Autotuner::parse_kernel(const std::string& name, ModExpBatch::Kernel& kernel) {
+    if (name == "scalar") kernel = ModExpBatch::KERNEL_SCALAR;
+    else if (name == "avx2") kernel = ModExpBatch::KERNEL_AVX2;
+    else if (name == "avx512") kernel = ModExpBatch::KERNEL_AVX512;
+    else return false;
+    return true;
+}
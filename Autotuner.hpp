@@ -0,0 +1,90 @@
+/**
+ * @file Autotuner.hpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ */
+
+#ifndef AUTOTUNER_HPP
+#define AUTOTUNER_HPP
+
+#include <string>
+#include <cstddef>
+#include "Caesar.hpp"
+#include "ModExpBatch.hpp"
+
+//! TuningConfig struktúra
+/*!
+  Egy gépre hangolt beállítások.
+*/
+struct TuningConfig {
+  //! Caesar UTF-8 mód ASCII kereső kernele (vektorszélesség)
+  Caesar::AsciiKernel asciiKernel;
+  //! ChunkedContainer alapértelmezett darabmérete
+  size_t chunkSize;
+  //! ChunkedContainer::decrypt_parallel() alapértelmezett szálszáma
+  unsigned threads;
+  //! RSA::power() és a kötegelésre nem kerülő skalár hatványozások ablakmérete
+  unsigned modexpWindow;
+  //! A kötegelt (ModExpBatch) hatványozás kernele
+  ModExpBatch::Kernel modexpKernel;
+};
+
+//! Autotuner osztály
+/*!
+  Induláskor (vagy kérésre) mikrobenchmarkokkal kiválasztja a leggyorsabb
+  Caesar és RSA beállításokat, és egy gépenkénti cache fájlba menti őket.
+  Későbbi induláskor a cache fájlt használja, így a kalibráció nem fut le újra.
+
+  Környezeti változók:
+  - ENCRYPTION_TUNING_CACHE: a cache fájl útvonala
+  - ENCRYPTION_RECALIBRATE=1: a cache figyelmen kívül hagyása, újrakalibrálás
+  - ENCRYPTION_ASCII_KERNEL (scalar | sse2 | avx2), ENCRYPTION_CHUNK_SIZE,
+    ENCRYPTION_THREADS, ENCRYPTION_MODEXP_WINDOW,
+    ENCRYPTION_MODEXP_KERNEL (scalar | avx2 | avx512): az adott érték felülírása
+*/
+class Autotuner {
+public:
+
+  // defaults függvény
+  static TuningConfig defaults();
+
+  // calibrate függvény
+  static TuningConfig calibrate();
+
+  // load függvény
+  static bool load(const std::string& path, TuningConfig& config);
+
+  // save függvény
+  static bool save(const std::string& path, const TuningConfig& config);
+
+  // apply_env függvény
+  static void apply_env(TuningConfig& config);
+
+  // apply függvény
+  static void apply(const TuningConfig& config);
+
+  // initialize függvény
+  static TuningConfig initialize(bool* calibrated = nullptr);
+
+  // cache_path függvény
+  static std::string cache_path();
+
+  // host_fingerprint függvény
+  static std::string host_fingerprint();
+
+  // kernel_name függvény
+  static const char* kernel_name(Caesar::AsciiKernel kernel);
+
+  // parse_kernel függvény
+  static bool parse_kernel(const std::string& name, Caesar::AsciiKernel& kernel);
+
+  // kernel_name függvény (ModExpBatch)
+  static const char* kernel_name(ModExpBatch::Kernel kernel);
+
+  // parse_kernel függvény (ModExpBatch)
+  static bool parse_kernel(const std::string& name, ModExpBatch::Kernel& kernel);
+};
+
+#endif
@@ -8,8 +8,433 @@
 
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <algorithm>
 #include "Caesar.hpp"
 
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define CAESAR_X86_SIMD 1
+#endif
+
+const char* const Caesar::HUNGARIAN_LOWER = "aábcdeéfghiíjklmnoóöőpqrstuúüűvwxyz";
+const char* const Caesar::HUNGARIAN_UPPER = "AÁBCDEÉFGHIÍJKLMNOÓÖŐPQRSTUÚÜŰVWXYZ";
+
+namespace {
+
+//! ascii_prefix_scalar függvény
+/*!
+  Bájtonként keresi az első nem ASCII bájtot.
+*/
+size_t ascii_prefix_scalar(const char* p, size_t n) {
+  size_t i = 0;
+  while (i < n && static_cast<unsigned char>(p[i]) < 0x80) ++i;
+  return i;
+}
+
+#ifdef CAESAR_X86_SIMD
+//! ascii_prefix_sse2 függvény
+/*!
+  16 bájtonként vizsgálja a felső bitet (movemask), a maradékot bájtonként.
+*/
+__attribute__((target("sse2")))
+size_t ascii_prefix_sse2(const char* p, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + i));
+    unsigned mask = static_cast<unsigned>(_mm_movemask_epi8(v));
+    if (mask) return i + __builtin_ctz(mask);
+  }
+  return i + ascii_prefix_scalar(p + i, n - i);
+}
+
+//! ascii_prefix_avx2 függvény
+/*!
+  32 bájtonként vizsgálja a felső bitet, a maradékot az SSE2 változat kapja.
+*/
+__attribute__((target("avx2")))
+size_t ascii_prefix_avx2(const char* p, size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + i));
+    unsigned mask = static_cast<unsigned>(_mm256_movemask_epi8(v));
+    if (mask) return i + __builtin_ctz(mask);
+  }
+  return i + ascii_prefix_sse2(p + i, n - i);
+}
+#endif
+
+}
+
+//! UTF-8 konstruktor
+/*!
+  \param shift eltolás mértéke
+  \param lower az abc kisbetűi UTF-8 kódolva, sorrendben
+  \param upper az abc nagybetűi, a kisbetűkkel azonos sorrendben
+
+  UTF-8 módban a betűk a megadott abc-n belül tolódnak el (pl. magyar abc esetén 'a' + 1 = 'á'),
+  a betűk kis- vagy nagybetűs volta megmarad. Az abc-ben nem szereplő kódpontok, valamint a
+  hibás UTF-8 bájtok változatlanul maradnak. Ha a két abc hossza eltér, üres, hibás UTF-8-at
+  tartalmaz vagy egy kódpont kétszer szerepel, std::invalid_argument kivételt dob.
+  Az eltolást az abc méretére redukálja.
+*/
+Caesar::Caesar(int shift, const std::string& lower, const std::string& upper)
+  : shift_(shift), utf8_(true) {
+  std::vector<std::string> upperLetters;
+  for (int pass = 0; pass < 2; ++pass) {
+    const std::string& abc = pass == 0 ? lower : upper;
+    std::vector<std::string>& target = pass == 0 ? letters_ : upperLetters;
+    for (size_t i = 0; i < abc.size();) {
+      uint32_t cp;
+      size_t len = decode_utf8(abc.data() + i, abc.size() - i, cp);
+      if (len == 0)
+        throw std::invalid_argument("Caesar: hibás UTF-8 az abc-ben");
+      target.push_back(abc.substr(i, len));
+      i += len;
+    }
+  }
+  if (letters_.empty() || letters_.size() != upperLetters.size())
+    throw std::invalid_argument("Caesar: a kis- és nagybetűs abc hossza eltér");
+  letters_.insert(letters_.end(), upperLetters.begin(), upperLetters.end());
+  shift_ %= static_cast<int>(upperLetters.size());
+
+  for (size_t i = 0; i < letters_.size(); ++i) {
+    uint32_t cp;
+    decode_utf8(letters_[i].data(), letters_[i].size(), cp);
+    if (!index_.insert(std::make_pair(cp, i)).second)
+      throw std::invalid_argument("Caesar: ismétlődő betű az abc-ben");
+  }
+
+  build_ascii_table(shift_, asciiEncrypt_);
+  build_ascii_table(-shift_, asciiDecrypt_);
+}
+
+//! decode_utf8 függvény
+/*!
+  \param p a bájtsorozat eleje
+  \param n a hátralévő bájtok száma
+  \param codePoint ide kerül a dekódolt kódpont
+  \return a kódpont hossza bájtban, hibás vagy csonka sorozat esetén 0
+*/
+size_t Caesar::decode_utf8(const char* p, size_t n, uint32_t& codePoint) {
+  if (n == 0) return 0;
+  unsigned char b0 = static_cast<unsigned char>(p[0]);
+  size_t len;
+  uint32_t cp;
+  if (b0 < 0x80) { codePoint = b0; return 1; }
+  else if (b0 >= 0xC2 && b0 <= 0xDF) { len = 2; cp = b0 & 0x1F; }
+  else if (b0 >= 0xE0 && b0 <= 0xEF) { len = 3; cp = b0 & 0x0F; }
+  else if (b0 >= 0xF0 && b0 <= 0xF4) { len = 4; cp = b0 & 0x07; }
+  else return 0;
+  if (n < len) return 0;
+
+  for (size_t i = 1; i < len; ++i) {
+    unsigned char b = static_cast<unsigned char>(p[i]);
+    if ((b & 0xC0) != 0x80) return 0;
+    cp = (cp << 6) | (b & 0x3F);
+  }
+  // túl hosszú kódolás, surrogate és 0x10FFFF feletti értékek kiszűrése
+  if ((len == 3 && cp < 0x800) || (len == 4 && (cp < 0x10000 || cp > 0x10FFFF))
+      || (cp >= 0xD800 && cp <= 0xDFFF))
+    return 0;
+  codePoint = cp;
+  return len;
+}
+
+//! kernel_supported függvény
+/*!
+  \param kernel ASCII kereső kernel
+  \return igaz, ha a kernel ezen a processzoron futtatható
+*/
+bool Caesar::kernel_supported(AsciiKernel kernel) {
+#ifdef CAESAR_X86_SIMD
+  __builtin_cpu_init();
+#endif
+  switch (kernel) {
+    case ASCII_SCALAR: return true;
+#ifdef CAESAR_X86_SIMD
+    case ASCII_SSE2: return __builtin_cpu_supports("sse2");
+    case ASCII_AVX2: return __builtin_cpu_supports("avx2");
+#endif
+    default: return false;
+  }
+}
+
+//! best_ascii_kernel függvény
+/*!
+  \return a legszélesebb támogatott ASCII kereső kernel
+*/
+Caesar::AsciiKernel Caesar::best_ascii_kernel() {
+  if (kernel_supported(ASCII_AVX2)) return ASCII_AVX2;
+  if (kernel_supported(ASCII_SSE2)) return ASCII_SSE2;
+  return ASCII_SCALAR;
+}
+
+//! asciiKernel_ változó
+/*!
+  Az aktuálisan használt ASCII kereső kernel; alapértelmezetten a legszélesebb támogatott.
+*/
+std::atomic<int> Caesar::asciiKernel_(Caesar::best_ascii_kernel());
+
+//! set_ascii_kernel függvény
+/*!
+  \param kernel a használandó ASCII kereső kernel
+  \return hamis, ha a kernel ezen a processzoron nem támogatott (ekkor nem vált)
+*/
+bool Caesar::set_ascii_kernel(AsciiKernel kernel) {
+  if (!kernel_supported(kernel)) return false;
+  asciiKernel_.store(kernel, std::memory_order_relaxed);
+  return true;
+}
+
+//! ascii_kernel függvény
+/*!
+  \return az aktuálisan használt ASCII kereső kernel
+*/
+Caesar::AsciiKernel Caesar::ascii_kernel() {
+  return static_cast<AsciiKernel>(asciiKernel_.load(std::memory_order_relaxed));
+}
+
+//! ascii_prefix függvény
+/*!
+  \param p a bájtsorozat eleje
+  \param n a bájtok száma
+  \return az elejéről összefüggő ASCII bájtok száma
+
+  A set_ascii_kernel() által beállított kernelt használja: AVX2 esetén 32,
+  SSE2 esetén 16 bájtot vizsgál egyszerre.
+*/
+size_t Caesar::ascii_prefix(const char* p, size_t n) {
+  switch (asciiKernel_.load(std::memory_order_relaxed)) {
+#ifdef CAESAR_X86_SIMD
+    case ASCII_AVX2: return ascii_prefix_avx2(p, n);
+    case ASCII_SSE2: return ascii_prefix_sse2(p, n);
+#endif
+    default: return ascii_prefix_scalar(p, n);
+  }
+}
+
+//! build_ascii_table függvény
+/*!
+  \param shift eltolás mértéke
+  \param table ide kerül mind a 128 ASCII bájt eltolt alakja (UTF-8 módban több bájtos is lehet)
+*/
+void Caesar::build_ascii_table(int shift, AsciiTable& table) const {
+  table.singleByte = true;
+  for (size_t c = 0; c < 128; ++c) {
+    char byte = static_cast<char>(c);
+    size_t written = 0;
+    shift_code_point(&byte, 1, shift, table.packed[c], written);
+    table.length[c] = static_cast<unsigned char>(written);
+    table.bytes[c] = table.packed[c][0];
+    if (written != 1)
+      table.singleByte = false;
+  }
+}
+
+//! shift_code_point függvény
+/*!
+  \param p a bájtsorozat eleje
+  \param n a hátralévő bájtok száma
+  \param shift eltolás mértéke
+  \param out ide írja az eredményt (legalább 4 bájt hely kell)
+  \param written ide kerül a kiírt bájtok száma
+  \return a feldolgozott bájtok száma (legalább 1)
+*/
+size_t Caesar::shift_code_point(const char* p, size_t n, int shift, char* out, size_t& written) const {
+  uint32_t cp;
+  size_t len = decode_utf8(p, n, cp);
+  if (len == 0) {
+    out[0] = p[0];
+    written = 1;
+    return 1;
+  }
+  std::unordered_map<uint32_t, size_t>::const_iterator it = index_.find(cp);
+  if (it == index_.end()) {
+    std::memcpy(out, p, len);
+    written = len;
+    return len;
+  }
+  long long size = static_cast<long long>(letters_.size() / 2);
+  long long pos = static_cast<long long>(it->second % size);
+  size_t caseOffset = it->second - pos;
+  const std::string& letter = letters_[caseOffset + static_cast<size_t>(((pos + shift) % size + size) % size)];
+  std::memcpy(out, letter.data(), letter.size());
+  written = letter.size();
+  return len;
+}
+
+namespace {
+
+//! StringSink struktúra
+/*!
+  A transform_into() kimenete std::string-be: a sztringet duplázva növeli,
+  és csak a végén vágja a tényleges hosszra.
+*/
+struct StringSink {
+  std::string& out;
+  size_t used;
+
+  explicit StringSink(std::string& s) : out(s), used(0) {}
+
+  char* grow(size_t bytes) {
+    if (out.size() < used + bytes)
+      out.resize(std::max(used + bytes, 2 * out.size()));
+    return &out[used];
+  }
+  void done(char* end) { used = end - &out[0]; }
+  void finish() { out.resize(used); }
+};
+
+//! BufferSink struktúra
+/*!
+  A transform_into() kimenete a hívó pufferébe. Ha egy grow() kérés nem fér
+  bele, a további kimenetet egy belső sztringbe írja, így a szükséges méret
+  akkor is pontosan kiderül; ha a végeredmény mégis elfér, finish() visszamásolja.
+*/
+struct BufferSink {
+  char* base;
+  size_t cap;
+  size_t used;
+  std::string spill;
+  bool spilled;
+
+  BufferSink(char* out, size_t capacity) : base(out), cap(capacity), used(0), spilled(false) {}
+
+  char* grow(size_t bytes) {
+    if (!spilled && used + bytes <= cap)
+      return base + used;
+    if (!spilled) {
+      if (used != 0)
+        spill.assign(base, used);
+      spilled = true;
+    }
+    if (spill.size() < used + bytes)
+      spill.resize(std::max(used + bytes, 2 * spill.size()));
+    return &spill[used];
+  }
+  void done(char* end) { used = end - (spilled ? &spill[0] : base); }
+  size_t finish() {
+    if (spilled && used <= cap && used != 0)
+      std::memcpy(base, spill.data(), used);
+    return used;
+  }
+};
+
+}
+
+//! transform_into függvény
+/*!
+  \param p bemenet
+  \param n a bemenet hossza
+  \param shift eltolás mértéke
+  \param table az ASCII bájtok előre kiszámolt eltolt alakja
+  \param sink a kimenet: grow(k) legalább k bájt helyet ad, done(end) rögzíti a kiírt részt
+
+  Az összefüggő ASCII szakaszok végét SIMD-del keresi meg, majd a szakaszt
+  egyben fordítja: ha minden ASCII bájt egy bájtra képeződik, a 128 elemes
+  char táblázatból, különben a 4 bájtos csomagolt alakok másolásával.
+  Csak a nem ASCII bájtoknál dekódol UTF-8-at.
+*/
+template <class Sink>
+void Caesar::transform_into(const char* p, size_t n, int shift, const AsciiTable& table, Sink& sink) const {
+  size_t i = 0;
+  while (i < n) {
+    size_t run = ascii_prefix(p + i, n - i);
+    if (run != 0) {
+      const unsigned char* src = reinterpret_cast<const unsigned char*>(p + i);
+      if (table.singleByte) {
+        char* dst = sink.grow(run);
+        for (size_t k = 0; k < run; ++k)
+          dst[k] = table.bytes[src[k]];
+        sink.done(dst + run);
+      } else {
+        char* dst = sink.grow(run * 4);
+        for (size_t k = 0; k < run; ++k) {
+          std::memcpy(dst, table.packed[src[k]], 4);
+          dst += table.length[src[k]];
+        }
+        sink.done(dst);
+      }
+      i += run;
+    }
+    if (i < n) {
+      char* dst = sink.grow(4);
+      size_t written = 0;
+      i += shift_code_point(p + i, n - i, shift, dst, written);
+      sink.done(dst + written);
+    }
+  }
+}
+
+//! transform függvény
+/*!
+  \param text bemenet
+  \param shift eltolás mértéke
+  \param table az ASCII bájtok előre kiszámolt eltolt alakja
+  \return eltolt szöveg
+*/
+std::string Caesar::transform(const std::string& text, int shift, const AsciiTable& table) const {
+  std::string out;
+  StringSink sink(out);
+  transform_into(text.data(), text.size(), shift, table, sink);
+  sink.finish();
+  return out;
+}
+
+//! transform_buffer függvény
+/*!
+  \param p bemenet
+  \param n a bemenet hossza
+  \param shift eltolás mértéke
+  \param table az ASCII bájtok előre kiszámolt eltolt alakja
+  \param out a hívó puffere
+  \param cap a puffer mérete
+  \return a kimenet hossza; ha nagyobb, mint cap, a puffer tartalma meghatározatlan
+*/
+size_t Caesar::transform_buffer(const char* p, size_t n, int shift, const AsciiTable& table, char* out, size_t cap) const {
+  BufferSink sink(out, cap);
+  transform_into(p, n, shift, table, sink);
+  return sink.finish();
+}
+
+//! encrypt függvény (hívó által adott pufferbe)
+/*!
+  \param text Titkosítandó szöveg
+  \param n a szöveg hossza
+  \param out a hívó puffere
+  \param cap a puffer mérete
+  \return a titkosított szöveg hossza; ha nagyobb, mint cap, a puffer tartalma meghatározatlan
+
+  Ugyanazt számolja, mint az encrypt(const std::string&), de köztes sztring nélkül
+  közvetlenül a hívó pufferébe ír (a C ABI erre épül).
+*/
+size_t Caesar::encrypt(const char* text, size_t n, char* out, size_t cap) const {
+  if (utf8_)
+    return transform_buffer(text, n, shift_, asciiEncrypt_, out, cap);
+  if (n <= cap)
+    for (size_t i = 0; i < n; ++i)
+      out[i] = shift_char(text[i], shift_);
+  return n;
+}
+
+//! decrypt függvény (hívó által adott pufferbe)
+/*!
+  \param secrettext Titkos szöveg
+  \param n a szöveg hossza
+  \param out a hívó puffere
+  \param cap a puffer mérete
+  \return a visszafejtett szöveg hossza; ha nagyobb, mint cap, a puffer tartalma meghatározatlan
+*/
+size_t Caesar::decrypt(const char* secrettext, size_t n, char* out, size_t cap) const {
+  if (utf8_)
+    return transform_buffer(secrettext, n, -shift_, asciiDecrypt_, out, cap);
+  if (n <= cap)
+    for (size_t i = 0; i < n; ++i)
+      out[i] = shift_char(secrettext[i], -shift_);
+  return n;
+}
+
 //! encrypt függvény
 /*!
   \param text Titkosítandó szöveg
@@ -17,6 +442,8 @@
   Titkosítja a beérkező sztringet és visszaadja a titkosított sztringet;
 */
 std::string Caesar::encrypt(const std::string& text) const{
+    if (utf8_)
+      return transform(text, shift_, asciiEncrypt_);
     std::string secrettext;
     for (char c : text) {
       secrettext += shift_char(c, shift_);
@@ -32,6 +459,8 @@ std::string Caesar::encrypt(const std::string& text) const{
   Visszafejti a titkos szöveget
 */
 std::string Caesar::decrypt(const std::string& secrettext) const{
+    if (utf8_)
+      return transform(secrettext, -shift_, asciiDecrypt_);
     std::string text;
     for (char c : secrettext) {
       text += shift_char(c, -shift_);
@@ -39,6 +468,49 @@ std::string Caesar::decrypt(const std::string& secrettext) const{
     return text;
 }
 
+//! decrypt_step függvény
+/*!
+  \param p a titkos szöveg aktuális pozíciója
+  \param n a hátralévő bájtok száma (legalább 1)
+  \param out ide fűzi hozzá a visszafejtett egységet
+  \return a feldolgozott bájtok száma
+
+  Egyetlen egységet fejt vissza: alap módban egy bájtot, UTF-8 módban egy kódpontot.
+  A lusta visszafejtő nézet (CaesarDecryptView) erre épül.
+*/
+size_t Caesar::decrypt_step(const char* p, size_t n, std::string& out) const {
+  if (!utf8_) {
+    out += shift_char(p[0], -shift_);
+    return 1;
+  }
+  unsigned char b = static_cast<unsigned char>(p[0]);
+  if (b < 0x80) {
+    out.append(asciiDecrypt_.packed[b], asciiDecrypt_.length[b]);
+    return 1;
+  }
+  char unit[4];
+  size_t written = 0;
+  size_t len = shift_code_point(p, n, -shift_, unit, written);
+  out.append(unit, written);
+  return len;
+}
+
+//! split_point függvény
+/*!
+  \param text a darabolandó szöveg
+  \param pos a kívánt vágási pont
+  \return UTF-8 módban pos, vagy az előtte lévő legközelebbi kódpont-kezdet
+  (legfeljebb 3 bájttal korábban); alap módban mindig pos
+*/
+size_t Caesar::split_point(const std::string& text, size_t pos) const {
+  if (!utf8_ || pos >= text.size())
+    return std::min(pos, text.size());
+  size_t cut = pos;
+  while (cut > 0 && pos - cut < 3 && (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80)
+    --cut;
+  return (static_cast<unsigned char>(text[cut]) & 0xC0) == 0x80 ? pos : cut;
+}
+
 //! get_public_key függvény
 /*!
   A kompatibilitás miatt muszáj inicializálni a függvént, még akkor is ha nem ad vissza semmit
@@ -53,4 +525,4 @@ std::string Caesar::get_public_key() const {
 */
 std::string Caesar::get_private_key() const {
     return "";
-}
\ No newline at end of file
+}
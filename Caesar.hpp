@@ -11,6 +11,10 @@
 
 #include <iostream>
 #include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+#include <atomic>
 #include "Encryption.hpp"
 
 //! Caesar osztály
@@ -19,16 +23,74 @@ private:
 
   // shift_char függvény
   static char shift_char(char c, int shift) {
-    if (!isalpha(c)) return c;
-    char base = isupper(c) ? 'A' : 'a';
-    return (c - base + shift + 26) % 26 + base;
+    unsigned char u = static_cast<unsigned char>(c);
+    bool upper = u >= 'A' && u <= 'Z';
+    if (!upper && !(u >= 'a' && u <= 'z')) return c;
+    char base = upper ? 'A' : 'a';
+    return (c - base + shift % 26 + 26) % 26 + base;
   }
   // shift változó
   int shift_;
+
+  // UTF-8 mód be van-e kapcsolva
+  bool utf8_;
+
+  // Az abc betűi UTF-8 kódolva: először a kisbetűk, utána a nagybetűk
+  std::vector<std::string> letters_;
+
+  // Kódpont -> index a letters_ vektorban
+  std::unordered_map<uint32_t, size_t> index_;
+
+  //! Az ASCII bájtok előre kiszámolt eltolt alakja UTF-8 módban
+  struct AsciiTable {
+    // igaz, ha minden ASCII bájt egyetlen bájtra képeződik (ekkor a bytes tábla használható)
+    bool singleByte;
+    char bytes[128];
+    // az általános eset: legfeljebb 4 bájtos UTF-8 alak és annak hossza
+    char packed[128][4];
+    unsigned char length[128];
+  };
+
+  // ASCII bájtok titkosított / visszafejtett alakja UTF-8 módban
+  AsciiTable asciiEncrypt_;
+  AsciiTable asciiDecrypt_;
+
+  // transform függvény
+  std::string transform(const std::string& text, int shift, const AsciiTable& table) const;
+
+  // transform_buffer függvény
+  size_t transform_buffer(const char* p, size_t n, int shift, const AsciiTable& table, char* out, size_t cap) const;
+
+  // transform_into függvény
+  template <class Sink>
+  void transform_into(const char* p, size_t n, int shift, const AsciiTable& table, Sink& sink) const;
+
+  // shift_code_point függvény
+  size_t shift_code_point(const char* p, size_t n, int shift, char* out, size_t& written) const;
+
+  // build_ascii_table függvény
+  void build_ascii_table(int shift, AsciiTable& table) const;
+
+  // Az aktuálisan használt ASCII kereső kernel
+  static std::atomic<int> asciiKernel_;
+
 public:
 
+  //! ASCII szakaszokat kereső kernelek (a vizsgált blokk szélessége szerint)
+  enum AsciiKernel { ASCII_SCALAR = 0, ASCII_SSE2 = 1, ASCII_AVX2 = 2 };
+
+  //! A magyar abc egy kódpontos kisbetűi (a kettős és hármas betűk nélkül)
+  static const char* const HUNGARIAN_LOWER;
+
+  //! A magyar abc egy kódpontos nagybetűi
+  static const char* const HUNGARIAN_UPPER;
+
   // Konstruktor
-  Caesar(int shift) : shift_(shift) {}
+  // (az eltolást az abc méretére redukálja, így a -shift_ sem csordulhat túl)
+  Caesar(int shift) : shift_(shift % 26), utf8_(false), asciiEncrypt_(), asciiDecrypt_() {}
+
+  // UTF-8 konstruktor
+  Caesar(int shift, const std::string& lower, const std::string& upper);
 
   // encrypt függvény deklarációja
   std::string encrypt(const std::string& text) const override;
@@ -36,12 +98,42 @@ public:
    // decrypt függvény deklarációja
   std::string decrypt(const std::string& secrettext) const override;
 
+   // encrypt függvény deklarációja (hívó által adott pufferbe)
+  size_t encrypt(const char* text, size_t n, char* out, size_t cap) const;
+
+   // decrypt függvény deklarációja (hívó által adott pufferbe)
+  size_t decrypt(const char* secrettext, size_t n, char* out, size_t cap) const;
+
+   // split_point függvény deklarációja
+  size_t split_point(const std::string& text, size_t pos) const override;
+
    // get_public_key függvény deklarációja
   std::string get_public_key() const override;
 
    // get_private_key függvény deklarációja
   std::string get_private_key() const override;
 
+   // decrypt_step függvény deklarációja
+  size_t decrypt_step(const char* p, size_t n, std::string& out) const;
+
+   // decode_utf8 függvény deklarációja
+  static size_t decode_utf8(const char* p, size_t n, uint32_t& codePoint);
+
+   // ascii_prefix függvény deklarációja
+  static size_t ascii_prefix(const char* p, size_t n);
+
+   // kernel_supported függvény deklarációja
+  static bool kernel_supported(AsciiKernel kernel);
+
+   // best_ascii_kernel függvény deklarációja
+  static AsciiKernel best_ascii_kernel();
+
+   // set_ascii_kernel függvény deklarációja
+  static bool set_ascii_kernel(AsciiKernel kernel);
+
+   // ascii_kernel függvény deklarációja
+  static AsciiKernel ascii_kernel();
+
 };
 
-#endif
\ No newline at end of file
+#endif
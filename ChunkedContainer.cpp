@@ -0,0 +1,422 @@
+/**
+ * @file ChunkedContainer.cpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ */
+
+#include "ChunkedContainer.hpp"
+#include <string>
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
+
+namespace {
+
+const char HEADER_MAGIC[4] = {'E', 'N', 'C', 'C'};
+const char TRAILER_MAGIC[4] = {'E', 'N', 'C', 'I'};
+const uint32_t FORMAT_VERSION = 2;
+const size_t HEADER_SIZE = 4 + 4 + 8 + 8;
+const size_t ENTRY_SIZE = 8 + 8 + 8 + 8 + 4 + 4;
+const size_t TRAILER_SIZE = 8 + 8 + 4;
+
+//! crc32 függvény
+/*!
+    \param data adat
+    \param size adat hossza
+    \return CRC32 (IEEE) ellenőrzőösszeg
+    A táblázatot az első hívás tölti fel.
+*/
+uint32_t crc32(const char* data, size_t size) {
+    static const std::vector<uint32_t> table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; ++k)
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    uint32_t crc = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; ++i)
+        crc = table[(crc ^ static_cast<unsigned char>(data[i])) & 0xFF] ^ (crc >> 8);
+    return crc ^ 0xFFFFFFFFu;
+}
+
+void putU32(std::string& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i)
+        out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+void putU64(std::string& out, uint64_t v) {
+    for (int i = 0; i < 8; ++i)
+        out += static_cast<char>((v >> (8 * i)) & 0xFF);
+}
+
+uint32_t getU32(const std::string& in, size_t pos) {
+    uint32_t v = 0;
+    for (int i = 0; i < 4; ++i)
+        v |= static_cast<uint32_t>(static_cast<unsigned char>(in[pos + i])) << (8 * i);
+    return v;
+}
+
+uint64_t getU64(const std::string& in, size_t pos) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; ++i)
+        v |= static_cast<uint64_t>(static_cast<unsigned char>(in[pos + i])) << (8 * i);
+    return v;
+}
+
+}
+
+std::atomic<size_t> ChunkedContainer::defaultChunkSize_(ChunkedContainer::DEFAULT_CHUNK_SIZE);
+std::atomic<unsigned> ChunkedContainer::defaultThreads_(0);
+
+//! Konstruktor
+/*!
+    \param cipher a darabok titkosítására használt algoritmus
+    \param chunkSize egy darab nyílt szövegének mérete bájtban (0 esetén default_chunk_size())
+    A tároló csak hivatkozást tárol az algoritmusra, annak élettartama alatt használható.
+*/
+ChunkedContainer::ChunkedContainer(const Encryption& cipher, size_t chunkSize)
+    : cipher_(cipher), chunkSize_(chunkSize != 0 ? chunkSize : default_chunk_size()) {
+}
+
+//! set_default_chunk_size függvény
+/*!
+    \param chunkSize az új alapértelmezett darabméret (0 esetén DEFAULT_CHUNK_SIZE)
+*/
+void ChunkedContainer::set_default_chunk_size(size_t chunkSize) {
+    defaultChunkSize_.store(chunkSize != 0 ? chunkSize : DEFAULT_CHUNK_SIZE, std::memory_order_relaxed);
+}
+
+//! default_chunk_size függvény
+/*!
+    \return az alapértelmezett darabméret
+*/
+size_t ChunkedContainer::default_chunk_size() {
+    return defaultChunkSize_.load(std::memory_order_relaxed);
+}
+
+//! set_default_threads függvény
+/*!
+    \param threads a decrypt_parallel() alapértelmezett szálszáma (0 esetén a hardver szálszáma)
+*/
+void ChunkedContainer::set_default_threads(unsigned threads) {
+    defaultThreads_.store(threads, std::memory_order_relaxed);
+}
+
+//! default_threads függvény
+/*!
+    \return a decrypt_parallel() beállított alapértelmezett szálszáma (0: a hardver szálszáma)
+    A tárolt értéket adja vissza, így a set_default_threads(default_threads())
+    pár az automatikus beállítást is megőrzi.
+*/
+unsigned ChunkedContainer::default_threads() {
+    return defaultThreads_.load(std::memory_order_relaxed);
+}
+
+//! encrypt függvény
+/*!
+    \param plaintext titkosítandó szöveg
+    \return a teljes tároló (fejléc, darabok, index, lezáró)
+    Minden darabot külön titkosít, így azok egymástól függetlenül visszafejthetők.
+    A darab végét az Encryption::split_point() szerint jelhatárra igazítja, és a
+    darab nyílt szövegbeli helyét az indexbe írja. Titkosítás előtt az
+    Encryption::accepts() segítségével ellenőrzi a darabot; ha az algoritmus
+    nem fogadja el, std::invalid_argument kivételt dob.
+*/
+std::string ChunkedContainer::encrypt(const std::string& plaintext) const {
+    std::string out;
+    out.append(HEADER_MAGIC, 4);
+    putU32(out, FORMAT_VERSION);
+    putU64(out, chunkSize_);
+    putU64(out, plaintext.size());
+
+    std::vector<ChunkEntry> entries;
+    size_t begin = 0;
+    for (size_t nominal = 0; nominal < plaintext.size(); ) {
+        nominal += std::min(chunkSize_, plaintext.size() - nominal);
+        size_t end = nominal < plaintext.size() ? cipher_.split_point(plaintext, nominal) : nominal;
+        // a vágási pont nem lehet a darab eleje előtt, sem a névleges határ után
+        end = std::max(begin, std::min(end, nominal));
+        std::string chunk = plaintext.substr(begin, end - begin);
+        if (!cipher_.accepts(chunk))
+            throw std::invalid_argument("ChunkedContainer: a darab nem titkosítható");
+        std::string secret = cipher_.encrypt(chunk);
+
+        ChunkEntry entry;
+        entry.offset = out.size();
+        entry.length = secret.size();
+        entry.plainOffset = begin;
+        entry.plainLength = end - begin;
+        entry.checksum = crc32(secret.data(), secret.size());
+        entries.push_back(entry);
+        out += secret;
+        begin = end;
+    }
+
+    uint64_t indexOffset = out.size();
+    for (const ChunkEntry& entry : entries) {
+        putU64(out, entry.offset);
+        putU64(out, entry.length);
+        putU64(out, entry.plainOffset);
+        putU64(out, entry.plainLength);
+        putU32(out, entry.checksum);
+        putU32(out, 0);
+    }
+    putU64(out, indexOffset);
+    putU64(out, entries.size());
+    out.append(TRAILER_MAGIC, 4);
+    return out;
+}
+
+//! parse függvény
+/*!
+    \param container tároló
+    \return a fejléc adatai és az index helye
+    Ellenőrzi a fejlécet, a lezárót, hogy a darabok száma lefedi-e a nyílt
+    szöveg hosszát, és hogy az index a tárolón belül van. Az indexbejegyzéseket
+    nem olvassa be (azt a read_entry() végzi igény szerint), így a futásideje
+    nem függ a darabok számától.
+    Hibás formátum esetén std::runtime_error kivételt dob.
+*/
+ChunkedContainer::Layout ChunkedContainer::parse(const std::string& container) {
+    if (container.size() < HEADER_SIZE + TRAILER_SIZE
+        || container.compare(0, 4, HEADER_MAGIC, 4) != 0
+        || container.compare(container.size() - 4, 4, TRAILER_MAGIC, 4) != 0)
+        throw std::runtime_error("ChunkedContainer: hibás formátum");
+    if (getU32(container, 4) != FORMAT_VERSION)
+        throw std::runtime_error("ChunkedContainer: ismeretlen verzió");
+
+    Layout layout;
+    layout.chunkSize = getU64(container, 8);
+    layout.plaintextSize = getU64(container, 16);
+
+    size_t trailer = container.size() - TRAILER_SIZE;
+    layout.indexOffset = getU64(container, trailer);
+    layout.count = getU64(container, trailer + 8);
+    if (layout.chunkSize == 0)
+        throw std::runtime_error("ChunkedContainer: hibás fejléc");
+    // túlcsordulás nélkül: ceil(plaintextSize / chunkSize)
+    uint64_t expected = layout.plaintextSize / layout.chunkSize
+        + (layout.plaintextSize % layout.chunkSize != 0);
+    if (layout.count != expected || layout.count > UINT64_MAX / layout.chunkSize
+        || layout.count * layout.chunkSize < layout.plaintextSize || layout.indexOffset < HEADER_SIZE
+        || layout.indexOffset > trailer || (trailer - layout.indexOffset) / ENTRY_SIZE != layout.count
+        || (trailer - layout.indexOffset) % ENTRY_SIZE != 0)
+        throw std::runtime_error("ChunkedContainer: hibás index");
+    return layout;
+}
+
+//! read_entry függvény
+/*!
+    \param container tároló
+    \param layout a parse() eredménye
+    \param index a darab sorszáma
+    \return a darab indexbejegyzése
+    Ellenőrzi, hogy a darab a tárolón belül van, és hogy nyílt szövegbeli helye
+    a szövegen belül, legkésőbb a névleges határán (index * darabméret) kezdődik.
+    A szomszédos darabok folytonosságát a hívó ellenőrzi (expect_next()).
+    Hibás bejegyzés esetén std::runtime_error kivételt dob.
+*/
+ChunkedContainer::ChunkEntry ChunkedContainer::read_entry(const std::string& container, const Layout& layout, uint64_t index) {
+    if (index >= layout.count)
+        throw std::runtime_error("ChunkedContainer: nem létező darab");
+    size_t pos = layout.indexOffset + index * ENTRY_SIZE;
+    ChunkEntry entry;
+    entry.offset = getU64(container, pos);
+    entry.length = getU64(container, pos + 8);
+    entry.plainOffset = getU64(container, pos + 16);
+    entry.plainLength = getU64(container, pos + 24);
+    entry.checksum = getU32(container, pos + 32);
+    if (entry.offset < HEADER_SIZE || entry.offset > layout.indexOffset
+        || entry.length > layout.indexOffset - entry.offset
+        || (index == 0 && entry.plainOffset != 0) || entry.plainOffset > index * layout.chunkSize
+        || entry.plainOffset > layout.plaintextSize
+        || entry.plainLength > layout.plaintextSize - entry.plainOffset
+        || (index + 1 == layout.count && entry.plainOffset + entry.plainLength != layout.plaintextSize))
+        throw std::runtime_error("ChunkedContainer: hibás index");
+    return entry;
+}
+
+//! expect_next függvény
+/*!
+    \param previous az előző darab bejegyzése
+    \param next a következő darab bejegyzése
+    Ha a következő darab nem ott kezdődik, ahol az előző véget ért, std::runtime_error kivételt dob.
+*/
+void ChunkedContainer::expect_next(const ChunkEntry& previous, const ChunkEntry& next) {
+    if (next.plainOffset != previous.plainOffset + previous.plainLength)
+        throw std::runtime_error("ChunkedContainer: hibás index");
+}
+
+//! read_index függvény
+/*!
+    \param container tároló
+    \param layout a parse() eredménye
+    \return az összes indexbejegyzés, folytonosság-ellenőrzéssel
+*/
+std::vector<ChunkedContainer::ChunkEntry> ChunkedContainer::read_index(const std::string& container, const Layout& layout) {
+    std::vector<ChunkEntry> entries;
+    entries.reserve(layout.count);
+    for (uint64_t i = 0; i < layout.count; ++i) {
+        entries.push_back(read_entry(container, layout, i));
+        if (i != 0)
+            expect_next(entries[i - 1], entries[i]);
+    }
+    return entries;
+}
+
+//! decrypt_chunk függvény
+/*!
+    \param container tároló
+    \param entry a darab (ellenőrzött) indexbejegyzése
+    \return a darab visszafejtett nyílt szövege
+    Visszafejtés előtt ellenőrzi a darab CRC32 összegét, utána a nyílt szöveg
+    hosszát az indexhez; eltérés esetén std::runtime_error kivételt dob.
+*/
+std::string ChunkedContainer::decrypt_chunk(const std::string& container, const ChunkEntry& entry) const {
+    if (crc32(container.data() + entry.offset, entry.length) != entry.checksum)
+        throw std::runtime_error("ChunkedContainer: sérült darab");
+
+    std::string plain = cipher_.decrypt(container.substr(entry.offset, entry.length));
+    if (plain.size() != entry.plainLength)
+        throw std::runtime_error("ChunkedContainer: a darab hossza nem egyezik");
+    return plain;
+}
+
+//! decrypt függvény
+/*!
+    \param container tároló
+    \return a teljes nyílt szöveg
+    Sorban visszafejti az összes darabot.
+*/
+std::string ChunkedContainer::decrypt(const std::string& container) const {
+    Layout layout = parse(container);
+    std::vector<ChunkEntry> entries = read_index(container, layout);
+    std::string text;
+    for (const ChunkEntry& entry : entries)
+        text += decrypt_chunk(container, entry);
+    return text;
+}
+
+//! decrypt_range függvény
+/*!
+    \param container tároló
+    \param offset a kért tartomány eleje a nyílt szövegben
+    \param length a kért tartomány hossza (a szöveg végénél levágja)
+    \return a nyílt szöveg [offset, offset + length) része
+    Csak azoknak a daraboknak az indexbejegyzését olvassa be és csak azokat
+    fejti vissza, amelyek a tartományba esnek. Az első darab a névleges
+    offset / darabméret sorszámú, vagy (ha annak vége a jelhatárra igazítás
+    miatt az offset elé esik) az azt követő.
+    Ha az offset a szöveg végén túl van, std::out_of_range kivételt dob.
+*/
+std::string ChunkedContainer::decrypt_range(const std::string& container, size_t offset, size_t length) const {
+    Layout layout = parse(container);
+    if (offset > layout.plaintextSize)
+        throw std::out_of_range("ChunkedContainer: az offset a szövegen kívül esik");
+    length = std::min<uint64_t>(length, layout.plaintextSize - offset);
+
+    std::string text;
+    if (length == 0)
+        return text;
+
+    uint64_t end = static_cast<uint64_t>(offset) + length;
+    uint64_t i = offset / layout.chunkSize;
+    ChunkEntry entry = read_entry(container, layout, i);
+    while (entry.plainOffset + entry.plainLength <= offset) {
+        ChunkEntry next = read_entry(container, layout, ++i);
+        expect_next(entry, next);
+        entry = next;
+    }
+    for (;;) {
+        std::string plain = decrypt_chunk(container, entry);
+        size_t from = offset > entry.plainOffset ? offset - entry.plainOffset : 0;
+        size_t to = std::min<uint64_t>(plain.size(), end - entry.plainOffset);
+        text.append(plain, from, to - from);
+        if (entry.plainOffset + entry.plainLength >= end)
+            break;
+        ChunkEntry next = read_entry(container, layout, ++i);
+        expect_next(entry, next);
+        entry = next;
+    }
+    return text;
+}
+
+//! decrypt_parallel függvény
+/*!
+    \param container tároló
+    \param threads szálak száma (0 esetén default_threads(), ha az is 0, a hardver szálszáma)
+    \return a teljes nyílt szöveg
+    A darabokat a szálak között egyenletesen osztja szét. Az algoritmus
+    encrypt/decrypt függvényei const-ok, így egy példány több szálból is használható.
+    A szálakban dobott első kivételt a hívó szálban újradobja. Ha egy szál
+    indítása nem sikerül, a már elindultakat bevárja, és továbbdobja a kivételt.
+*/
+std::string ChunkedContainer::decrypt_parallel(const std::string& container, unsigned threads) const {
+    Layout layout = parse(container);
+    size_t count = layout.count;
+    if (threads == 0)
+        threads = default_threads();
+    if (threads == 0)
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    threads = static_cast<unsigned>(std::min<size_t>(threads, count));
+    if (threads <= 1)
+        return decrypt(container);
+
+    std::vector<ChunkEntry> entries = read_index(container, layout);
+    std::vector<std::string> parts(count);
+    std::vector<std::exception_ptr> errors(threads);
+    std::vector<std::thread> workers;
+    workers.reserve(threads);
+    try {
+        for (unsigned t = 0; t < threads; ++t) {
+            workers.push_back(std::thread([&, t] {
+                try {
+                    for (size_t i = t; i < count; i += threads)
+                        parts[i] = decrypt_chunk(container, entries[i]);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            }));
+        }
+    } catch (...) {
+        for (std::thread& worker : workers)
+            worker.join();
+        throw;
+    }
+    for (std::thread& worker : workers)
+        worker.join();
+    for (const std::exception_ptr& error : errors)
+        if (error)
+            std::rethrow_exception(error);
+
+    std::string text;
+    for (const std::string& part : parts)
+        text += part;
+    return text;
+}
+
+//! plaintext_size függvény
+/*!
+    \param container tároló
+    \return a nyílt szöveg hossza bájtban
+*/
+size_t ChunkedContainer::plaintext_size(const std::string& container) {
+    return parse(container).plaintextSize;
+}
+
+//! chunk_count függvény
+/*!
+    \param container tároló
+    \return a darabok száma
+*/
+size_t ChunkedContainer::chunk_count(const std::string& container) {
+    return parse(container).count;
+}
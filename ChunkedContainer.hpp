@@ -0,0 +1,120 @@
+/**
+ * @file ChunkedContainer.hpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ */
+
+#ifndef CHUNKED_CONTAINER_HPP
+#define CHUNKED_CONTAINER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <atomic>
+#include "Encryption.hpp"
+
+//! ChunkedContainer osztály
+/*!
+  Darabolt (chunkolt) titkosított tároló. A nyílt szöveget közel rögzített méretű,
+  egymástól függetlenül visszafejthető darabokra bontja, és a végére egy
+  indexet ír (offset, hossz, a nyílt szöveg offsetje és hossza, ellenőrzőösszeg).
+  Az i. darab névleges határa i * darabméret; ezt az Encryption::split_point()
+  legfeljebb néhány bájttal előrébb hozhatja, hogy egy többbájtos jel (pl. UTF-8
+  kódpont) ne kerüljön két darabba. Így egy tetszőleges
+  bájttartomány visszafejtéséhez csak az érintett darabokat kell feldolgozni,
+  illetve a darabok párhuzamosan is visszafejthetők.
+
+  Formátum (minden szám little-endian):
+  - fejléc: "ENCC" | verzió (u32) | darabméret (u64) | nyílt szöveg hossza (u64)
+  - darabok: egymás után a titkosított darabok
+  - index: darabonként offset (u64) | hossz (u64) | nyílt szöveg offsetje (u64) |
+    nyílt szöveg hossza (u64) | CRC32 (u32) | 0 (u32)
+  - lezáró: index offsetje (u64) | darabok száma (u64) | "ENCI"
+*/
+class ChunkedContainer {
+private:
+
+  //! Egy indexbejegyzés
+  struct ChunkEntry {
+    uint64_t offset;
+    uint64_t length;
+    uint64_t plainOffset;
+    uint64_t plainLength;
+    uint32_t checksum;
+  };
+
+  //! Beolvasott fejléc és az index helye
+  struct Layout {
+    uint64_t chunkSize;
+    uint64_t plaintextSize;
+    uint64_t indexOffset;
+    uint64_t count;
+  };
+
+  // A darabokat titkosító/visszafejtő algoritmus
+  const Encryption& cipher_;
+
+  // Egy darab nyílt szövegének mérete bájtban
+  size_t chunkSize_;
+
+  // Hangolható alapértelmezett darabméret és szálszám
+  static std::atomic<size_t> defaultChunkSize_;
+  static std::atomic<unsigned> defaultThreads_;
+
+  // parse függvény
+  static Layout parse(const std::string& container);
+
+  // read_entry függvény
+  static ChunkEntry read_entry(const std::string& container, const Layout& layout, uint64_t index);
+
+  // expect_next függvény
+  static void expect_next(const ChunkEntry& previous, const ChunkEntry& next);
+
+  // read_index függvény
+  static std::vector<ChunkEntry> read_index(const std::string& container, const Layout& layout);
+
+  // decrypt_chunk függvény
+  std::string decrypt_chunk(const std::string& container, const ChunkEntry& entry) const;
+
+public:
+
+  //! Alapértelmezett darabméret
+  static const size_t DEFAULT_CHUNK_SIZE = 4096;
+
+  // Konstruktor
+  ChunkedContainer(const Encryption& cipher, size_t chunkSize = 0);
+
+  // encrypt függvény
+  std::string encrypt(const std::string& plaintext) const;
+
+  // decrypt függvény
+  std::string decrypt(const std::string& container) const;
+
+  // decrypt_range függvény
+  std::string decrypt_range(const std::string& container, size_t offset, size_t length) const;
+
+  // decrypt_parallel függvény
+  std::string decrypt_parallel(const std::string& container, unsigned threads = 0) const;
+
+  // plaintext_size függvény
+  static size_t plaintext_size(const std::string& container);
+
+  // chunk_count függvény
+  static size_t chunk_count(const std::string& container);
+
+  // set_default_chunk_size függvény
+  static void set_default_chunk_size(size_t chunkSize);
+
+  // default_chunk_size függvény
+  static size_t default_chunk_size();
+
+  // set_default_threads függvény
+  static void set_default_threads(unsigned threads);
+
+  // default_threads függvény
+  static unsigned default_threads();
+};
+
+#endif
@@ -0,0 +1,69 @@
+/**
+ * @file DecryptView.cpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ */
+
+#include "DecryptView.hpp"
+#include <cstdlib>
+
+//! RSADecryptView::iterator konstruktor
+/*!
+    \param view a nézet
+    Rögtön visszafejti az első tokent (ha van).
+*/
+RSADecryptView::iterator::iterator(const RSADecryptView* view)
+    : view_(view), pos_(0), current_(0), end_(false) {
+    advance();
+}
+
+//! RSADecryptView::iterator::advance függvény
+/*!
+    A következő, szóközzel lezárt tokent olvassa be és fejti vissza. A lezáratlan
+    utolsó tokent - az RSA::decrypt() függvénnyel egyezően - figyelmen kívül hagyja.
+*/
+void RSADecryptView::iterator::advance() {
+    const std::string& titkos = *view_->titkos_;
+    size_t endPos = titkos.find(' ', pos_);
+    if (endPos == std::string::npos) {
+        end_ = true;
+        return;
+    }
+
+    std::string token = titkos.substr(pos_, endPos - pos_);
+    current_ = view_->rsa_->decrypt_token(std::strtoull(token.c_str(), nullptr, 10));
+    pos_ = endPos + 1;
+}
+
+//! CaesarDecryptView::iterator konstruktor
+/*!
+    \param view a nézet
+    Rögtön visszafejti az első egységet (ha van).
+*/
+CaesarDecryptView::iterator::iterator(const CaesarDecryptView* view)
+    : view_(view), pos_(0), bufferPos_(0), end_(false) {
+    advance();
+}
+
+//! CaesarDecryptView::iterator::advance függvény
+/*!
+    A pufferben lévő következő bájtra lép; ha a puffer elfogyott, a következő
+    egységet fejti vissza a Caesar::decrypt_step() segítségével.
+*/
+void CaesarDecryptView::iterator::advance() {
+    if (bufferPos_ + 1 < buffer_.size()) {
+        ++bufferPos_;
+        return;
+    }
+
+    const std::string& titkos = *view_->titkos_;
+    if (pos_ >= titkos.size()) {
+        end_ = true;
+        return;
+    }
+    buffer_.clear();
+    bufferPos_ = 0;
+    pos_ += view_->caesar_->decrypt_step(titkos.data() + pos_, titkos.size() - pos_, buffer_);
+}
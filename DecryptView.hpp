@@ -0,0 +1,144 @@
+/**
+ * @file DecryptView.hpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ */
+
+#ifndef DECRYPT_VIEW_HPP
+#define DECRYPT_VIEW_HPP
+
+#include <string>
+#include <iterator>
+#include <cstddef>
+#include "RSA.hpp"
+#include "Caesar.hpp"
+
+//! RSADecryptView osztály
+/*!
+  Lusta visszafejtő nézet RSA titkos szövegre. Nem építi fel a teljes
+  visszafejtett sztringet: a tokeneket csak akkor fejti vissza, amikor az
+  iterátor odaér, így pl. std::find vagy std::equal korai leállásakor csak a
+  ténylegesen beolvasott rész kerül feldolgozásra.
+
+  A nézet nem másolja a titkos szöveget és az RSA objektumot, ezeknek tovább
+  kell élniük, mint a nézetnek és az iterátorainak.
+*/
+class RSADecryptView {
+private:
+
+  const RSA* rsa_;
+  const std::string* titkos_;
+
+public:
+
+  //! Input iterátor a visszafejtett karakterekre
+  class iterator {
+  private:
+    const RSADecryptView* view_;
+    size_t pos_;
+    char current_;
+    bool end_;
+
+    // advance függvény
+    void advance();
+
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef char value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const char* pointer;
+    typedef const char& reference;
+
+    // Konstruktor (end iterátor)
+    iterator() : view_(nullptr), pos_(0), current_(0), end_(true) {}
+
+    // Konstruktor (begin iterátor)
+    explicit iterator(const RSADecryptView* view);
+
+    reference operator*() const { return current_; }
+    pointer operator->() const { return &current_; }
+    iterator& operator++() { advance(); return *this; }
+    iterator operator++(int) { iterator tmp = *this; advance(); return tmp; }
+
+    bool operator==(const iterator& other) const {
+      return end_ == other.end_ && (end_ || pos_ == other.pos_);
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+  };
+
+  // Konstruktor
+  RSADecryptView(const RSA& rsa, const std::string& titkos) : rsa_(&rsa), titkos_(&titkos) {}
+
+  // Ideiglenes sztringre nem hozható létre nézet
+  RSADecryptView(const RSA& rsa, std::string&& titkos) = delete;
+
+  iterator begin() const { return iterator(this); }
+  iterator end() const { return iterator(); }
+};
+
+//! CaesarDecryptView osztály
+/*!
+  Lusta visszafejtő nézet Caesar titkos szövegre. Egyszerre egy egységet
+  (alap módban egy bájtot, UTF-8 módban egy kódpontot) fejt vissza, és annak
+  bájtjait adja vissza sorban.
+
+  A nézet nem másolja a titkos szöveget és a Caesar objektumot, ezeknek tovább
+  kell élniük, mint a nézetnek és az iterátorainak.
+*/
+class CaesarDecryptView {
+private:
+
+  const Caesar* caesar_;
+  const std::string* titkos_;
+
+public:
+
+  //! Input iterátor a visszafejtett bájtokra
+  class iterator {
+  private:
+    const CaesarDecryptView* view_;
+    size_t pos_;
+    std::string buffer_;
+    size_t bufferPos_;
+    bool end_;
+
+    // advance függvény
+    void advance();
+
+  public:
+    typedef std::input_iterator_tag iterator_category;
+    typedef char value_type;
+    typedef std::ptrdiff_t difference_type;
+    typedef const char* pointer;
+    typedef const char& reference;
+
+    // Konstruktor (end iterátor)
+    iterator() : view_(nullptr), pos_(0), bufferPos_(0), end_(true) {}
+
+    // Konstruktor (begin iterátor)
+    explicit iterator(const CaesarDecryptView* view);
+
+    reference operator*() const { return buffer_[bufferPos_]; }
+    pointer operator->() const { return &buffer_[bufferPos_]; }
+    iterator& operator++() { advance(); return *this; }
+    iterator operator++(int) { iterator tmp = *this; advance(); return tmp; }
+
+    bool operator==(const iterator& other) const {
+      return end_ == other.end_ && (end_ || (pos_ == other.pos_ && bufferPos_ == other.bufferPos_));
+    }
+    bool operator!=(const iterator& other) const { return !(*this == other); }
+  };
+
+  // Konstruktor
+  CaesarDecryptView(const Caesar& caesar, const std::string& titkos) : caesar_(&caesar), titkos_(&titkos) {}
+
+  // Ideiglenes sztringre nem hozható létre nézet
+  CaesarDecryptView(const Caesar& caesar, std::string&& titkos) = delete;
+
+  iterator begin() const { return iterator(this); }
+  iterator end() const { return iterator(); }
+};
+
+#endif
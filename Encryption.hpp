@@ -50,6 +50,21 @@ public:
       RSA-hoz a privát kulcs lekérdezése.
     */
   virtual std::string get_private_key() const = 0;
+
+  //! accepts függvény.
+    /*!
+      Igaz, ha az encrypt() el tudja fogadni a szöveget. Alapértelmezetten minden szöveget elfogad;
+      a szűkebb bemenetű algoritmusok (pl. RSA) felüldefiniálják, így a hívó titkosítás és
+      hibaüzenet nélkül ellenőrizhet.
+    */
+  virtual bool accepts(const std::string& plaintext) const { (void)plaintext; return true; }
+
+  //! split_point függvény.
+    /*!
+      A pos-nál nem nagyobb legnagyobb index, ahol a szöveg egy jel (pl. többbájtos
+      UTF-8 kódpont) szétvágása nélkül darabolható. Alapértelmezetten minden bájthatár jó.
+    */
+  virtual size_t split_point(const std::string& plaintext, size_t pos) const { (void)plaintext; return pos; }
 };
 
 #endif
\ No newline at end of file
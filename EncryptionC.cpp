@@ -0,0 +1,328 @@
+/**
+ * @file EncryptionC.cpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ */
+
+#include "EncryptionC.h"
+#include "Caesar.hpp"
+#include "RSA.hpp"
+#include "Autotuner.hpp"
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <vector>
+
+//! enc_cipher struktúra
+/*!
+  A C oldalon átlátszatlan leíró mögötti C++ objektum.
+*/
+struct enc_cipher {
+  std::unique_ptr<Encryption> impl;
+  // Caesar leírónál ugyanaz az objektum, mint az impl (a pufferes hívásokhoz), RSA-nál nullptr
+  const Caesar* caesar;
+  // RSA leírónál ugyanaz az objektum, mint az impl (a kötegelt hívásokhoz), Caesar-nál nullptr
+  const RSA* rsa;
+  bool utf8;
+};
+
+namespace {
+
+//! guarded függvény
+/*!
+  \param f a végrehajtandó művelet
+  \return a művelet hibakódja
+  Minden kivételt hibakóddá alakít, hogy ne lépjen át a C határon.
+*/
+template <class F>
+enc_status guarded(F f) {
+  try {
+    return f();
+  } catch (const std::bad_alloc&) {
+    return ENC_ERR_OUT_OF_MEMORY;
+  } catch (const std::invalid_argument&) {
+    return ENC_ERR_INVALID_ARGUMENT;
+  } catch (...) {
+    return ENC_ERR_INTERNAL;
+  }
+}
+
+//! copy_out függvény
+/*!
+  Átmásolja az eredményt a hívó pufferébe. Ha az nem elég nagy, az out_len-be a szükséges méret kerül.
+*/
+enc_status copy_out(const std::string& s, char* out, size_t out_cap, size_t* out_len) {
+  *out_len = s.size();
+  if (s.size() > out_cap)
+    return ENC_ERR_BUFFER_TOO_SMALL;
+  if (!s.empty()) {
+    if (!out)
+      return ENC_ERR_NULL_POINTER;
+    std::memcpy(out, s.data(), s.size());
+  }
+  return ENC_OK;
+}
+
+//! run függvény
+/*!
+  Egy puffer titkosítása vagy visszafejtése. Caesar leírónál a kimenet köztes
+  sztring nélkül, közvetlenül a hívó pufferébe kerül; RSA-nál a bemenetet
+  egyszer bemásolja egy std::string-be, az eredményt pedig a hívó pufferébe.
+*/
+enc_status run(const enc_cipher* cipher, bool encrypt, const char* in, size_t in_len,
+               char* out, size_t out_cap, size_t* out_len) {
+  if (!cipher || !out_len || (!in && in_len != 0) || (!out && out_cap != 0))
+    return ENC_ERR_NULL_POINTER;
+  *out_len = 0;
+
+  return guarded([&]() -> enc_status {
+    if (cipher->caesar) {
+      size_t n = encrypt ? cipher->caesar->encrypt(in, in_len, out, out_cap)
+                         : cipher->caesar->decrypt(in, in_len, out, out_cap);
+      *out_len = n;
+      return n > out_cap ? ENC_ERR_BUFFER_TOO_SMALL : ENC_OK;
+    }
+    std::string input(in ? in : "", in_len);
+    if (encrypt && !cipher->impl->accepts(input))
+      return ENC_ERR_INVALID_INPUT;
+    std::string result = encrypt ? cipher->impl->encrypt(input) : cipher->impl->decrypt(input);
+    return copy_out(result, out, out_cap, out_len);
+  });
+}
+
+//! run_rsa_batch függvény
+/*!
+  RSA leíró kötegelt hívása. Az elemeket egyenként ellenőrzi, majd az összes
+  szabályos elemet egy RSA::encrypt_all() / decrypt_all() hívásnak adja át,
+  így sok rövid üzenet betűi együtt kerülnek a ModExpBatch SIMD kerneleire.
+  Ha ez kivételt dob, minden még függő elem a kivételnek megfelelő kódot kapja.
+*/
+void run_rsa_batch(const enc_cipher* cipher, bool encrypt, const enc_input* in,
+                   enc_output* out, size_t count) {
+  size_t visited = 0;
+  std::vector<size_t> pending;
+  enc_status status = guarded([&]() -> enc_status {
+    std::vector<std::string> inputs;
+    for (; visited < count; ++visited) {
+      const enc_input& item = in[visited];
+      out[visited].len = 0;
+      if ((!item.data && item.len != 0) || (!out[visited].data && out[visited].cap != 0)) {
+        out[visited].status = ENC_ERR_NULL_POINTER;
+        continue;
+      }
+      std::string input(item.data ? item.data : "", item.len);
+      if (encrypt && !cipher->rsa->accepts(input)) {
+        out[visited].status = ENC_ERR_INVALID_INPUT;
+        continue;
+      }
+      pending.push_back(visited);
+      inputs.push_back(std::move(input));
+    }
+
+    std::vector<std::string> results = encrypt ? cipher->rsa->encrypt_all(inputs)
+                                               : cipher->rsa->decrypt_all(inputs);
+    for (size_t k = 0; k < pending.size(); ++k) {
+      enc_output& o = out[pending[k]];
+      o.status = copy_out(results[k], o.data, o.cap, &o.len);
+    }
+    pending.clear();
+    return ENC_OK;
+  });
+  if (status != ENC_OK) {
+    for (size_t i : pending)
+      out[i].status = status;
+    for (size_t i = visited; i < count; ++i)
+      out[i].status = status;
+  }
+}
+
+//! run_batch függvény
+/*!
+  Kötegelt titkosítás vagy visszafejtés; minden elem saját hibakódot kap.
+  RSA-nál a run_rsa_batch() egy menetben hatványoz, Caesar-nál elemenként a run() fut.
+*/
+enc_status run_batch(const enc_cipher* cipher, bool encrypt, const enc_input* in,
+                     enc_output* out, size_t count) {
+  if (!cipher || (count != 0 && (!in || !out)))
+    return ENC_ERR_NULL_POINTER;
+
+  if (cipher->rsa) {
+    run_rsa_batch(cipher, encrypt, in, out, count);
+  } else {
+    for (size_t i = 0; i < count; ++i)
+      out[i].status = run(cipher, encrypt, in[i].data, in[i].len, out[i].data, out[i].cap, &out[i].len);
+  }
+
+  enc_status first = ENC_OK;
+  for (size_t i = 0; i < count && first == ENC_OK; ++i)
+    first = out[i].status;
+  return first;
+}
+
+// Az Autotuner::initialize() egyszeri futtatását védő zár és jelző
+std::mutex tuneMutex;
+bool tuned = false;
+
+//! tune_once függvény
+/*!
+  Folyamatonként egyszer lefuttatja az Autotuner::initialize()-t; a calibrated-be
+  (ha nem NULL) az kerül, hogy ez a hívás kalibrált-e. Ha kivételt dob, nem
+  számít lefutottnak, a következő hívás újrapróbálja.
+*/
+enc_status tune_once(bool* calibrated) {
+  std::lock_guard<std::mutex> lock(tuneMutex);
+  if (calibrated)
+    *calibrated = false;
+  if (tuned)
+    return ENC_OK;
+  Autotuner::initialize(calibrated);
+  tuned = true;
+  return ENC_OK;
+}
+
+//! make_cipher függvény
+/*!
+  Leíró létrehozása egy már elkészült C++ objektum köré.
+*/
+enc_status make_cipher(Encryption* impl, const Caesar* caesar, const RSA* rsa, bool utf8, enc_cipher** out) {
+  std::unique_ptr<Encryption> owned(impl);
+  // a hangolás hibája nem akadályozza a leíró létrehozását
+  guarded([]() { return tune_once(nullptr); });
+  enc_cipher* cipher = new enc_cipher;
+  cipher->impl = std::move(owned);
+  cipher->caesar = caesar;
+  cipher->rsa = rsa;
+  cipher->utf8 = utf8;
+  *out = cipher;
+  return ENC_OK;
+}
+
+}
+
+extern "C" {
+
+//! enc_autotune_initialize függvény
+enc_status enc_autotune_initialize(int32_t* calibrated) {
+  if (calibrated)
+    *calibrated = 0;
+  return guarded([&]() {
+    bool ran = false;
+    enc_status status = tune_once(&ran);
+    if (calibrated)
+      *calibrated = ran ? 1 : 0;
+    return status;
+  });
+}
+
+//! enc_caesar_new függvény
+enc_status enc_caesar_new(int32_t shift, enc_cipher** out) {
+  if (!out)
+    return ENC_ERR_NULL_POINTER;
+  *out = nullptr;
+  return guarded([&]() {
+    Caesar* caesar = new Caesar(shift);
+    return make_cipher(caesar, caesar, nullptr, false, out);
+  });
+}
+
+//! enc_caesar_new_utf8 függvény
+enc_status enc_caesar_new_utf8(int32_t shift, const char* lower, size_t lower_len,
+                               const char* upper, size_t upper_len, enc_cipher** out) {
+  if (!out || !lower || !upper)
+    return ENC_ERR_NULL_POINTER;
+  *out = nullptr;
+  return guarded([&]() {
+    Caesar* caesar = new Caesar(shift, std::string(lower, lower_len), std::string(upper, upper_len));
+    return make_cipher(caesar, caesar, nullptr, true, out);
+  });
+}
+
+//! enc_rsa_new függvény
+enc_status enc_rsa_new(enc_cipher** out) {
+  if (!out)
+    return ENC_ERR_NULL_POINTER;
+  *out = nullptr;
+  return guarded([&]() {
+    RSA* rsa = new RSA();
+    return make_cipher(rsa, nullptr, rsa, false, out);
+  });
+}
+
+//! enc_free függvény
+void enc_free(enc_cipher* cipher) {
+  delete cipher;
+}
+
+//! enc_output_bound függvény
+/*!
+  Alap Caesar módban a kimenet pontosan akkora, mint a bemenet. UTF-8 módban egy
+  bájtból legfeljebb 4 bájtos kódpont lesz, RSA-nál egy karakterből legfeljebb
+  3 számjegy és egy szóköz.
+*/
+enc_status enc_output_bound(const enc_cipher* cipher, size_t in_len, size_t* bound) {
+  if (!cipher || !bound)
+    return ENC_ERR_NULL_POINTER;
+  size_t factor = (cipher->rsa || cipher->utf8) ? 4 : 1;
+  if (in_len > static_cast<size_t>(-1) / factor)
+    return ENC_ERR_INVALID_ARGUMENT;
+  *bound = in_len * factor;
+  return ENC_OK;
+}
+
+//! enc_encrypt függvény
+enc_status enc_encrypt(const enc_cipher* cipher, const char* in, size_t in_len,
+                       char* out, size_t out_cap, size_t* out_len) {
+  return run(cipher, true, in, in_len, out, out_cap, out_len);
+}
+
+//! enc_decrypt függvény
+enc_status enc_decrypt(const enc_cipher* cipher, const char* in, size_t in_len,
+                       char* out, size_t out_cap, size_t* out_len) {
+  return run(cipher, false, in, in_len, out, out_cap, out_len);
+}
+
+//! enc_encrypt_batch függvény
+enc_status enc_encrypt_batch(const enc_cipher* cipher, const enc_input* in,
+                             enc_output* out, size_t count) {
+  return run_batch(cipher, true, in, out, count);
+}
+
+//! enc_decrypt_batch függvény
+enc_status enc_decrypt_batch(const enc_cipher* cipher, const enc_input* in,
+                             enc_output* out, size_t count) {
+  return run_batch(cipher, false, in, out, count);
+}
+
+//! enc_get_public_key függvény
+enc_status enc_get_public_key(const enc_cipher* cipher, char* out, size_t out_cap, size_t* out_len) {
+  if (!cipher || !out_len)
+    return ENC_ERR_NULL_POINTER;
+  return guarded([&]() { return copy_out(cipher->impl->get_public_key(), out, out_cap, out_len); });
+}
+
+//! enc_get_private_key függvény
+enc_status enc_get_private_key(const enc_cipher* cipher, char* out, size_t out_cap, size_t* out_len) {
+  if (!cipher || !out_len)
+    return ENC_ERR_NULL_POINTER;
+  return guarded([&]() { return copy_out(cipher->impl->get_private_key(), out, out_cap, out_len); });
+}
+
+//! enc_status_message függvény
+const char* enc_status_message(enc_status status) {
+  switch (status) {
+    case ENC_OK: return "ok";
+    case ENC_ERR_NULL_POINTER: return "null pointer";
+    case ENC_ERR_INVALID_ARGUMENT: return "invalid argument";
+    case ENC_ERR_INVALID_INPUT: return "invalid input";
+    case ENC_ERR_BUFFER_TOO_SMALL: return "buffer too small";
+    case ENC_ERR_OUT_OF_MEMORY: return "out of memory";
+    case ENC_ERR_INTERNAL: return "internal error";
+    default: return "unknown error";
+  }
+}
+
+}
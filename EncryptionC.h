@@ -0,0 +1,111 @@
+/**
+ * @file EncryptionC.h
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ * Stabil C ABI a Caesar és RSA osztályokhoz (libencryption.so).
+ * A függvények soha nem dobnak kivételt, a hibákat enc_status kóddal jelzik.
+ * A bemeneti és kimeneti puffereket a hívó birtokolja, a könyvtár nem foglal
+ * olyan memóriát, amit a hívónak kellene felszabadítania (a leírót kivéve).
+ */
+
+#ifndef ENCRYPTION_C_H
+#define ENCRYPTION_C_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(__GNUC__) || defined(__clang__)
+#define ENC_API __attribute__((visibility("default")))
+#else
+#define ENC_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+//! Hibakód típus
+typedef int32_t enc_status;
+
+#define ENC_OK                    0  //!< Sikeres művelet
+#define ENC_ERR_NULL_POINTER      1  //!< Kötelező mutató NULL
+#define ENC_ERR_INVALID_ARGUMENT  2  //!< Hibás paraméter (pl. hibás abc)
+#define ENC_ERR_INVALID_INPUT     3  //!< A bemenet nem titkosítható (pl. RSA-nál nem betű)
+#define ENC_ERR_BUFFER_TOO_SMALL  4  //!< A kimeneti puffer kicsi, a szükséges méret az out_len-be kerül (a puffer tartalma ilyenkor meghatározatlan)
+#define ENC_ERR_OUT_OF_MEMORY     5  //!< Memóriafoglalási hiba
+#define ENC_ERR_INTERNAL          6  //!< Egyéb belső hiba
+
+//! Átlátszatlan leíró egy Caesar vagy RSA példányhoz
+typedef struct enc_cipher enc_cipher;
+
+//! Kötegelt hívás egy bemeneti puffere
+typedef struct enc_input {
+  const char* data;
+  size_t len;
+} enc_input;
+
+//! Kötegelt hívás egy kimeneti puffere
+typedef struct enc_output {
+  char* data;         //!< a hívó puffere
+  size_t cap;         //!< a puffer mérete
+  size_t len;         //!< a kiírt (vagy hiba esetén a szükséges) bájtok száma
+  enc_status status;  //!< az adott elem hibakódja
+} enc_output;
+
+//! A gépre hangolt beállítások betöltése (első futáskor kalibrálás), folyamatonként egyszer
+/*!
+  Betölti a hangolási cache-t, vagy ha az nem használható, kalibrál és elmenti;
+  az ENCRYPTION_* környezeti változók itt érvényesülnek. Ha a hívó nem hívja meg,
+  az első leíró létrehozása futtatja. A további hívások nem csinálnak semmit.
+  Ha calibrated nem NULL, 1 kerül bele, ha ez a hívás kalibrált, különben 0.
+*/
+ENC_API enc_status enc_autotune_initialize(int32_t* calibrated);
+
+//! Caesar példány létrehozása (alap mód)
+ENC_API enc_status enc_caesar_new(int32_t shift, enc_cipher** out);
+
+//! Caesar példány létrehozása UTF-8 módban a megadott kis- és nagybetűs abc-vel
+ENC_API enc_status enc_caesar_new_utf8(int32_t shift, const char* lower, size_t lower_len,
+                                       const char* upper, size_t upper_len, enc_cipher** out);
+
+//! RSA példány létrehozása új kulcspárral
+ENC_API enc_status enc_rsa_new(enc_cipher** out);
+
+//! Leíró felszabadítása (NULL-ra nem csinál semmit)
+ENC_API void enc_free(enc_cipher* cipher);
+
+//! A kimenet méretének felső becslése in_len hosszú bemenetre (titkosítás és visszafejtés)
+ENC_API enc_status enc_output_bound(const enc_cipher* cipher, size_t in_len, size_t* bound);
+
+//! Egy puffer titkosítása
+ENC_API enc_status enc_encrypt(const enc_cipher* cipher, const char* in, size_t in_len,
+                               char* out, size_t out_cap, size_t* out_len);
+
+//! Egy puffer visszafejtése
+ENC_API enc_status enc_decrypt(const enc_cipher* cipher, const char* in, size_t in_len,
+                               char* out, size_t out_cap, size_t* out_len);
+
+//! Több puffer titkosítása egy hívással; az első hibás elem kódjával tér vissza
+ENC_API enc_status enc_encrypt_batch(const enc_cipher* cipher, const enc_input* in,
+                                     enc_output* out, size_t count);
+
+//! Több puffer visszafejtése egy hívással; az első hibás elem kódjával tér vissza
+ENC_API enc_status enc_decrypt_batch(const enc_cipher* cipher, const enc_input* in,
+                                     enc_output* out, size_t count);
+
+//! Nyilvános kulcs lekérdezése szövegként (Caesar esetén üres)
+ENC_API enc_status enc_get_public_key(const enc_cipher* cipher, char* out, size_t out_cap, size_t* out_len);
+
+//! Privát kulcs lekérdezése szövegként (Caesar esetén üres)
+ENC_API enc_status enc_get_private_key(const enc_cipher* cipher, char* out, size_t out_cap, size_t* out_len);
+
+//! A hibakód szöveges leírása (statikus sztring)
+ENC_API const char* enc_status_message(enc_status status);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
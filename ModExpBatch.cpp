@@ -0,0 +1,251 @@
+/**
+ * @file ModExpBatch.cpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ */
+
+#include "ModExpBatch.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <immintrin.h>
+#define MODEXP_X86_SIMD 1
+#endif
+
+namespace {
+
+//! Egy vektoros blokkban feldolgozott sávok száma
+const size_t LANES = 8;
+
+//! scalar_modexp függvény
+/*!
+    Bitenkénti moduláris hatványozás egy sávra (a maradék elemekhez és nagy modulushoz).
+    Az alapot előbb redukálja, így base < modulus esetén az RSA::modularExponentiation()
+    függvénnyel azonos eredményt ad.
+*/
+unsigned long long scalar_modexp(unsigned long long base, unsigned long long exponent, unsigned long long modulus) {
+    unsigned long long result = 1;
+    base %= modulus;
+    while (exponent > 0) {
+        if (exponent % 2 == 1)
+            result = (result * base) % modulus;
+        base = (base * base) % modulus;
+        exponent /= 2;
+    }
+    return result;
+}
+
+//! bit_length függvény
+/*!
+    \return a blokk legnagyobb kitevőjének bithossza (ennyi lépést kell a blokkon végigvinni)
+*/
+int bit_length(const unsigned long long* exponents, size_t stride) {
+    unsigned long long all = 0;
+    for (size_t k = 0; k < LANES; ++k)
+        all |= exponents[k * stride];
+    int bits = 0;
+    for (; all != 0; all >>= 1)
+        ++bits;
+    return bits;
+}
+
+#ifdef MODEXP_X86_SIMD
+//! mulmod_avx2 függvény
+/*!
+    (a * b) mod m négy sávban: q = floor(a * b / m) becslése 1/m-mel szorozva,
+    majd a maradék egy-egy korrekciós lépéssel a [0, m) tartományba kerül.
+*/
+__attribute__((target("avx2")))
+inline __m256d mulmod_avx2(__m256d a, __m256d b, __m256d m, __m256d inv) {
+    __m256d x = _mm256_mul_pd(a, b);
+    __m256d q = _mm256_floor_pd(_mm256_mul_pd(x, inv));
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(q, m));
+    r = _mm256_add_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, _mm256_setzero_pd(), _CMP_LT_OQ), m));
+    r = _mm256_sub_pd(r, _mm256_and_pd(_mm256_cmp_pd(r, m, _CMP_GE_OQ), m));
+    return r;
+}
+
+//! block_avx2 függvény
+/*!
+    Nyolc sáv hatványozása két, egymásba fésült 4 sávos AVX2 vektorral.
+    A sávok egy lépésben mindig négyzetre emelnek és szoroznak, a kitevő bitje csak a
+    keverés maszkját adja.
+*/
+__attribute__((target("avx2")))
+void block_avx2(const double* bases, const unsigned long long* exponents, size_t stride,
+                double modulus, double* out) {
+    __m256d m = _mm256_set1_pd(modulus);
+    __m256d inv = _mm256_set1_pd(1.0 / modulus);
+    __m256d b0 = _mm256_loadu_pd(bases), b1 = _mm256_loadu_pd(bases + 4);
+    __m256d r0 = _mm256_set1_pd(1.0), r1 = r0;
+    __m256i e0, e1;
+    if (stride == 0) {
+        e0 = e1 = _mm256_set1_epi64x(static_cast<long long>(exponents[0]));
+    } else {
+        e0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(exponents));
+        e1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(exponents + 4));
+    }
+
+    int bits = bit_length(exponents, stride);
+    for (int bit = 0; bit < bits; ++bit) {
+        __m256i bm = _mm256_set1_epi64x(static_cast<long long>(1ull << bit));
+        __m256d k0 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(e0, bm), bm));
+        __m256d k1 = _mm256_castsi256_pd(_mm256_cmpeq_epi64(_mm256_and_si256(e1, bm), bm));
+        r0 = _mm256_blendv_pd(r0, mulmod_avx2(r0, b0, m, inv), k0);
+        r1 = _mm256_blendv_pd(r1, mulmod_avx2(r1, b1, m, inv), k1);
+        b0 = mulmod_avx2(b0, b0, m, inv);
+        b1 = mulmod_avx2(b1, b1, m, inv);
+    }
+    _mm256_storeu_pd(out, r0);
+    _mm256_storeu_pd(out + 4, r1);
+}
+
+//! mulmod_avx512 függvény
+/*!
+    A mulmod_avx2 nyolc sávos változata maszkregiszteres korrekcióval.
+*/
+__attribute__((target("avx512f")))
+inline __m512d mulmod_avx512(__m512d a, __m512d b, __m512d m, __m512d inv) {
+    __m512d x = _mm512_mul_pd(a, b);
+    __m512d t = _mm512_mul_pd(x, inv);
+    __m512d q = _mm512_mask_roundscale_pd(t, 0xFF, t, _MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC);
+    __m512d r = _mm512_sub_pd(x, _mm512_mul_pd(q, m));
+    r = _mm512_mask_add_pd(r, _mm512_cmp_pd_mask(r, _mm512_setzero_pd(), _CMP_LT_OQ), r, m);
+    r = _mm512_mask_sub_pd(r, _mm512_cmp_pd_mask(r, m, _CMP_GE_OQ), r, m);
+    return r;
+}
+
+//! block_avx512 függvény
+/*!
+    Nyolc sáv hatványozása egy AVX-512 vektorral.
+*/
+__attribute__((target("avx512f")))
+void block_avx512(const double* bases, const unsigned long long* exponents, size_t stride,
+                  double modulus, double* out) {
+    __m512d m = _mm512_set1_pd(modulus);
+    __m512d inv = _mm512_set1_pd(1.0 / modulus);
+    __m512d b = _mm512_loadu_pd(bases);
+    __m512d r = _mm512_set1_pd(1.0);
+    __m512i e = stride == 0 ? _mm512_set1_epi64(static_cast<long long>(exponents[0]))
+                            : _mm512_loadu_si512(exponents);
+
+    int bits = bit_length(exponents, stride);
+    for (int bit = 0; bit < bits; ++bit) {
+        __mmask8 k = _mm512_test_epi64_mask(e, _mm512_set1_epi64(static_cast<long long>(1ull << bit)));
+        r = _mm512_mask_mov_pd(r, k, mulmod_avx512(r, b, m, inv));
+        b = mulmod_avx512(b, b, m, inv);
+    }
+    _mm512_storeu_pd(out, r);
+}
+#endif
+
+//! run függvény
+/*!
+    \param stride a kitevők közti lépésköz (0 = közös kitevő)
+    A teljes 8-as blokkokat a kiválasztott vektoros kernel, a maradékot skalár kód számolja.
+*/
+void run(const unsigned long long* bases, const unsigned long long* exponents, size_t stride,
+         unsigned long long modulus, unsigned long long* out, size_t n, int kernel) {
+    size_t i = 0;
+#ifdef MODEXP_X86_SIMD
+    if (kernel != ModExpBatch::KERNEL_SCALAR && modulus < ModExpBatch::MAX_VECTOR_MODULUS) {
+        double b[LANES], r[LANES];
+        for (; i + LANES <= n; i += LANES) {
+            for (size_t k = 0; k < LANES; ++k)
+                b[k] = static_cast<double>(bases[i + k] % modulus);
+            if (kernel == ModExpBatch::KERNEL_AVX512)
+                block_avx512(b, exponents + i * stride, stride, static_cast<double>(modulus), r);
+            else
+                block_avx2(b, exponents + i * stride, stride, static_cast<double>(modulus), r);
+            for (size_t k = 0; k < LANES; ++k)
+                out[i + k] = static_cast<unsigned long long>(r[k]);
+        }
+    }
+#else
+    (void)kernel;
+#endif
+    for (; i < n; ++i)
+        out[i] = scalar_modexp(bases[i], exponents[i * stride], modulus);
+}
+
+}
+
+//! kernel_ változó
+/*!
+    Alapértelmezetten a legszélesebb támogatott kernel.
+*/
+std::atomic<int> ModExpBatch::kernel_(ModExpBatch::best_kernel());
+
+//! compute függvény (közös kitevő)
+/*!
+    \param bases az alapok (n darab)
+    \param exponent minden elemre közös kitevő
+    \param modulus modulus
+    \param out ide kerülnek az eredmények (n darab)
+    \param n elemek száma
+    Az RSA titkosítás/visszafejtés esete: minden szimbólum ugyanazzal a kulccsal.
+*/
+void ModExpBatch::compute(const unsigned long long* bases, unsigned long long exponent,
+                          unsigned long long modulus, unsigned long long* out, size_t n) {
+    run(bases, &exponent, 0, modulus, out, n, kernel_.load(std::memory_order_relaxed));
+}
+
+//! compute függvény (soronkénti kitevő)
+/*!
+    \param bases az alapok (n darab)
+    \param exponents a kitevők (n darab)
+    \param modulus modulus
+    \param out ide kerülnek az eredmények (n darab)
+    \param n elemek száma
+*/
+void ModExpBatch::compute(const unsigned long long* bases, const unsigned long long* exponents,
+                          unsigned long long modulus, unsigned long long* out, size_t n) {
+    run(bases, exponents, 1, modulus, out, n, kernel_.load(std::memory_order_relaxed));
+}
+
+//! kernel_supported függvény
+/*!
+    \return igaz, ha a kernel ezen a processzoron futtatható
+*/
+bool ModExpBatch::kernel_supported(Kernel kernel) {
+#ifdef MODEXP_X86_SIMD
+    __builtin_cpu_init();
+#endif
+    switch (kernel) {
+        case KERNEL_SCALAR: return true;
+#ifdef MODEXP_X86_SIMD
+        case KERNEL_AVX2: return __builtin_cpu_supports("avx2");
+        case KERNEL_AVX512: return __builtin_cpu_supports("avx512f");
+#endif
+        default: return false;
+    }
+}
+
+//! best_kernel függvény
+/*!
+    \return a legszélesebb támogatott kernel
+*/
+ModExpBatch::Kernel ModExpBatch::best_kernel() {
+    if (kernel_supported(KERNEL_AVX512)) return KERNEL_AVX512;
+    if (kernel_supported(KERNEL_AVX2)) return KERNEL_AVX2;
+    return KERNEL_SCALAR;
+}
+
+//! set_kernel függvény
+/*!
+    \return hamis, ha a kernel ezen a processzoron nem támogatott (ekkor nem vált)
+*/
+bool ModExpBatch::set_kernel(Kernel kernel) {
+    if (!kernel_supported(kernel)) return false;
+    kernel_.store(kernel, std::memory_order_relaxed);
+    return true;
+}
+
+//! kernel függvény
+/*!
+    \return az aktuálisan használt kernel
+*/
+ModExpBatch::Kernel ModExpBatch::kernel() {
+    return static_cast<Kernel>(kernel_.load(std::memory_order_relaxed));
+}
@@ -0,0 +1,67 @@
+/**
+ * @file ModExpBatch.hpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ */
+
+#ifndef MOD_EXP_BATCH_HPP
+#define MOD_EXP_BATCH_HPP
+
+#include <cstddef>
+#include <atomic>
+
+//! ModExpBatch osztály
+/*!
+  Több egymástól független moduláris hatványozást végez egyszerre, SIMD
+  sávokban összefésülve (multi-buffer). A sávok SoA elrendezésben tárolják
+  az alapot, az eredményt és a kitevőt; az AVX2 kernel 2 x 4, az AVX-512
+  kernel 8 sávot visz egyszerre. A bitenkénti négyzetre emelés és szorzás
+  minden sávban ugyanazon a lépéssorozaton megy végig, a kitevő bitje csak azt
+  dönti el (maszkolt keveréssel), hogy a sáv megtartja-e a szorzatot.
+
+  A vektoros kernelek egy limbes, double pontosságú Barrett-redukciót
+  használnak, ezért csak MAX_VECTOR_MODULUS alatti modulusra működnek
+  (a szorzatok így pontosan ábrázolhatók). Nagyobb modulusnál és a 8-cal nem
+  osztható maradék elemeknél skalár kód fut.
+*/
+class ModExpBatch {
+private:
+
+  // Az aktuálisan használt kernel
+  static std::atomic<int> kernel_;
+
+public:
+
+  //! Kernelek
+  enum Kernel { KERNEL_SCALAR = 0, KERNEL_AVX2 = 1, KERNEL_AVX512 = 2 };
+
+  //! Ennyi elem alatt nem éri meg a kötegelés
+  static const size_t MIN_BATCH = 8;
+
+  //! A vektoros kernelek által kezelt legnagyobb modulus (kizárólag)
+  static const unsigned long long MAX_VECTOR_MODULUS = 1ull << 26;
+
+  // compute függvény (közös kitevő)
+  static void compute(const unsigned long long* bases, unsigned long long exponent,
+                      unsigned long long modulus, unsigned long long* out, size_t n);
+
+  // compute függvény (soronkénti kitevő)
+  static void compute(const unsigned long long* bases, const unsigned long long* exponents,
+                      unsigned long long modulus, unsigned long long* out, size_t n);
+
+  // kernel_supported függvény
+  static bool kernel_supported(Kernel kernel);
+
+  // best_kernel függvény
+  static Kernel best_kernel();
+
+  // set_kernel függvény
+  static bool set_kernel(Kernel kernel);
+
+  // kernel függvény
+  static Kernel kernel();
+};
+
+#endif
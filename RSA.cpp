@@ -13,6 +13,8 @@
 #include <sstream>
 #include <cstdlib>
 #include <ctime>
+#include <vector>
+#include "ModExpBatch.hpp"
 
 //! RSA_ALPHABET_SIZE
 /*!
@@ -55,7 +57,7 @@ unsigned long long RSA::gcd(unsigned long long a, unsigned long long b) const {
 
     Ez a konstruktor tehát egy új RSA objektumot hoz létre és inicializálja a nyilvános és privát kulcsokat a fenti lépések szerint.
 */
-RSA::RSA() {
+RSA::RSA() : constantTime(false) {
     unsigned long long p = generateRandomPrime(10000, 20000);
     unsigned long long q = generateRandomPrime(20000, 30000);
     unsigned long long phi = (p - 1) * (q - 1);
@@ -221,8 +223,18 @@ bool RSA::isPrime(unsigned long long num) const {
     6. Amikor az 'exponent' értéke eléri a 0-t, a ciklus befejeződik.
 
     7. Visszaadja az result értékét, ami a moduláris hatványozás eredménye.
+
+    Konstans idejű módban (set_constant_time()) a ladderExponentiation() számol,
+    egyébként 1-nél nagyobb ablakméretnél a windowedExponentiation().
 */
 unsigned long long RSA::modularExponentiation(unsigned long long base, unsigned long long exponent, unsigned long long modulus) const {
+    if (constantTime)
+      return ladderExponentiation(base, exponent, modulus);
+
+    unsigned window = modexpWindow_.load(std::memory_order_relaxed);
+    if (window > 1)
+      return windowedExponentiation(base, exponent, modulus, window);
+
     unsigned long long result = 1;
 
     while (exponent > 0) {
@@ -237,6 +249,159 @@ unsigned long long RSA::modularExponentiation(unsigned long long base, unsigned
 }
 
 
+//! ladderExponentiation függvény
+/*!
+   \param base alap
+   \param exponent kitevő
+   \param modulus modulus
+   \return moduláris hatványozás eredménye
+
+    Montgomery-létra: a kitevő mind a 64 bitjén végigmegy (a vezető nullákon is),
+    és minden lépésben pontosan egy szorzást és egy négyzetre emelést végez.
+    A kitevő bitje csak egy elágazás nélküli, maszkolt cserét vezérel, így a
+    futásidő és a memóriaelérések sorrendje nem függ a kitevőtől.
+    A maradékképzés (%) ideje egyes processzorokon az operandusoktól függhet;
+    a szorzatok itt kicsik (< modulus^2), ez a gyakorlatban nem okoz eltérést.
+*/
+unsigned long long RSA::ladderExponentiation(unsigned long long base, unsigned long long exponent, unsigned long long modulus) const {
+    unsigned long long r0 = 1 % modulus;
+    unsigned long long r1 = base % modulus;
+
+    for (int i = 63; i >= 0; --i) {
+      unsigned long long mask = 0 - ((exponent >> i) & 1);
+      unsigned long long swap = mask & (r0 ^ r1);
+      r0 ^= swap;
+      r1 ^= swap;
+
+      r1 = (r0 * r1) % modulus;
+      r0 = (r0 * r0) % modulus;
+
+      swap = mask & (r0 ^ r1);
+      r0 ^= swap;
+      r1 ^= swap;
+    }
+
+    return r0;
+}
+
+//! set_constant_time függvény
+/*!
+    \param enabled be- vagy kikapcsolja a konstans idejű módot
+
+    Konstans idejű módban minden hatványozás a ladderExponentiation()-nel fut
+    (a ModExpBatch kötegelés és az ablakos algoritmus nélkül), és az encrypt()
+    a hibás karakter keresésekor nem áll meg az első találatnál. A mód ára a
+    gyors úthoz képest a timing mérőprogrammal (make timing) mérhető.
+*/
+void RSA::set_constant_time(bool enabled) {
+    constantTime = enabled;
+}
+
+//! is_constant_time függvény
+/*!
+    \return igaz, ha a konstans idejű mód be van kapcsolva
+*/
+bool RSA::is_constant_time() const {
+    return constantTime;
+}
+
+//! power függvény
+/*!
+    \param base alap
+    \param exponent kitevő
+    \param modulus modulus
+    \return base^exponent mod modulus az aktuális módnak megfelelő algoritmussal
+    Elsősorban a timing mérőprogram számára, hogy a hatványozást kulcstól függetlenül is mérni lehessen.
+*/
+unsigned long long RSA::power(unsigned long long base, unsigned long long exponent, unsigned long long modulus) const {
+    return modularExponentiation(base, exponent, modulus);
+}
+
+//! exponentiateAll függvény
+/*!
+    \param bases alapok (mind kisebb, mint RSA_ALPHABET_SIZE)
+    \param exponent közös kitevő (a nyilvános vagy a privát kulcs)
+    \param powers ide kerülnek az eredmények
+    Ha legalább ModExpBatch::MIN_BATCH alap gyűlt össze, a független hatványozásokat
+    a ModExpBatch SIMD sávjaiban számolja, különben (és konstans idejű módban mindig)
+    a modularExponentiation()-nel egyenként.
+*/
+void RSA::exponentiateAll(const std::vector<unsigned long long>& bases, unsigned long long exponent, std::vector<unsigned long long>& powers) const {
+    powers.resize(bases.size());
+    if (!constantTime && bases.size() >= ModExpBatch::MIN_BATCH) {
+        ModExpBatch::compute(bases.data(), exponent, RSA_ALPHABET_SIZE, powers.data(), bases.size());
+        return;
+    }
+    for (size_t i = 0; i < bases.size(); ++i)
+        powers[i] = modularExponentiation(bases[i], exponent, RSA_ALPHABET_SIZE);
+}
+
+//! modexpWindow_ változó
+/*!
+    A moduláris hatványozás ablakmérete, alapértelmezetten 1 (bitenkénti algoritmus).
+*/
+std::atomic<unsigned> RSA::modexpWindow_(1);
+
+//! windowedExponentiation függvény
+/*!
+   \param base alap
+   \param exponent kitevő
+   \param modulus modulus
+   \param window ablakméret bitekben (2..MAX_MODEXP_WINDOW)
+   \return moduláris hatványozás eredménye
+
+    Fix ablakos (k-áris) moduláris hatványozás balról jobbra. Előre kiszámolja a
+    base^0 .. base^(2^window - 1) hatványokat, majd a kitevőt window bites
+    darabokban dolgozza fel: minden darabnál window-szor négyzetre emel, és egyszer
+    szoroz a táblázat megfelelő elemével. Nagy kitevőknél kevesebb szorzást végez,
+    mint a bitenkénti algoritmus.
+*/
+unsigned long long RSA::windowedExponentiation(unsigned long long base, unsigned long long exponent, unsigned long long modulus, unsigned window) const {
+    if (exponent == 0)
+      return 1;
+
+    unsigned long long table[1u << MAX_MODEXP_WINDOW];
+    unsigned long long mask = (1ull << window) - 1;
+    base %= modulus;
+    table[0] = 1 % modulus;
+    for (unsigned long long i = 1; i <= mask; ++i)
+      table[i] = (table[i - 1] * base) % modulus;
+
+    int bits = 0;
+    for (unsigned long long e = exponent; e != 0; e >>= 1)
+      ++bits;
+    int top = ((bits + window - 1) / window) * window;
+
+    unsigned long long result = table[0];
+    for (int shift = top - window; shift >= 0; shift -= window) {
+      for (unsigned i = 0; i < window; ++i)
+        result = (result * result) % modulus;
+      result = (result * table[(exponent >> shift) & mask]) % modulus;
+    }
+
+    return result;
+}
+
+//! set_modexp_window függvény
+/*!
+    \param window ablakméret bitekben (1..MAX_MODEXP_WINDOW)
+    \return hamis, ha az ablakméret a tartományon kívül esik (ekkor nem vált)
+*/
+bool RSA::set_modexp_window(unsigned window) {
+    if (window < 1 || window > MAX_MODEXP_WINDOW)
+      return false;
+    modexpWindow_.store(window, std::memory_order_relaxed);
+    return true;
+}
+
+//! modexp_window függvény
+/*!
+    \return az aktuális ablakméret
+*/
+unsigned RSA::modexp_window() {
+    return modexpWindow_.load(std::memory_order_relaxed);
+}
+
 //! encrypt függvény
 /*!
     \param eredeti A titkosítandó sztring
@@ -246,13 +411,17 @@ unsigned long long RSA::modularExponentiation(unsigned long long base, unsigned
     
     1. Először ellenőrzi az eredeti üzenet minden karakterét, hogy azok betűk vagy szóközök-e. 
     Ha talál olyan karaktert, ami nem betű és nem szóköz, akkor kiírja a "Nem szabályos karakter" üzenetet, 
-    és "Error" értéket ad vissza.
+    és "Error" értéket ad vissza. Konstans idejű módban előbb elágazás nélkül végigvizsgálja
+    az egész szöveget, így a futásidő nem árulja el az első hibás karakter helyét.
 
     2. Létrehoz két üres stringet: titkos és eredeti2. Az eredeti2 a toLowerCase() függvény segítségével átalakítja az eredeti üzenetet 
     kisbetűssé.
 
     3. Iterál az eredeti stringen a karakterek szerint.
 
+    A betűk hatványozását előre, egy menetben végzi az exponentiateAll() segítségével,
+    így elég hosszú szövegnél a ModExpBatch SIMD kernelei több betűt számolnak egyszerre.
+
     4. Az aktuális karaktert (aktualis) leellenőrzi, hogy egy szóköz-e. Ha igen, akkor a c értékét a RSA_ALPHABET_SIZE-ra állítja,
     ami különleges értékkel jelöli a szóközt. Ha nem szóköz, akkor kiszámolja a karakter titkosított értékét az RSA algoritmus segítségével. 
     Ehhez a modularExponentiation() metódust használja a karaktert átkonvertálva az 'a' értéktől kezdve számmá, 
@@ -265,22 +434,90 @@ unsigned long long RSA::modularExponentiation(unsigned long long base, unsigned
     7. Amikor végzett az összes karakterrel, visszaadja a titkos stringet, ami tartalmazza a titkosított üzenetet.
 */
 std::string RSA::encrypt(const std::string& eredeti) const {
-    for (size_t i = 0; i < eredeti.size(); ++i) {
-        char f = eredeti[i];
-        if (!std::isalpha(f) && f != ' ') {
+    if (constantTime) {
+        unsigned bad = 0;
+        for (size_t i = 0; i < eredeti.size(); ++i) {
+            unsigned char f = static_cast<unsigned char>(eredeti[i]);
+            unsigned letter = static_cast<unsigned>((f | 0x20) - 'a') < 26u;
+            bad |= !(letter | (f == ' '));
+        }
+        if (bad) {
             std::cout<<"Nem szabályos karakter"<<std::endl;
             return "Error";
         }
     }
+    if (!accepts(eredeti)) {
+        std::cout<<"Nem szabályos karakter"<<std::endl;
+        return "Error";
+    }
+    std::vector<unsigned long long> bases;
+    collect_letters(eredeti, bases);
+    std::vector<unsigned long long> powers;
+    exponentiateAll(bases, publicKey, powers);
+
     std::string titkos;
+    size_t next = 0;
+    format_cipher(eredeti, powers, next, titkos);
+    return titkos;
+}
+
+//! encrypt_all függvény
+/*!
+    \param texts a titkosítandó szövegek (mind csak betűt és szóközt tartalmazhat)
+    \return a szövegek titkosított alakja, sorrendben
+    Ugyanazt adja, mint az encrypt() szövegenként, de az összes szöveg betűit egy
+    exponentiateAll() hívásban hatványozza. Így sok rövid üzenet (egyenként
+    ModExpBatch::MIN_BATCH betű alatt) is a ModExpBatch SIMD kerneleire kerül.
+    Ha valamelyik szöveget az accepts() nem fogadja el, kiírás nélkül
+    std::invalid_argument kivételt dob.
+*/
+std::vector<std::string> RSA::encrypt_all(const std::vector<std::string>& texts) const {
+    std::vector<unsigned long long> bases;
+    for (const std::string& text : texts) {
+        if (!accepts(text))
+            throw std::invalid_argument("RSA: nem szabályos karakter");
+        collect_letters(text, bases);
+    }
+    std::vector<unsigned long long> powers;
+    exponentiateAll(bases, publicKey, powers);
+
+    std::vector<std::string> out(texts.size());
+    size_t next = 0;
+    for (size_t i = 0; i < texts.size(); ++i)
+        format_cipher(texts[i], powers, next, out[i]);
+    return out;
+}
+
+//! collect_letters függvény
+/*!
+    \param eredeti szabályos (csak betűt és szóközt tartalmazó) szöveg
+    \param bases ide fűzi a betűk 'a'-tól számolt sorszámát (a kisbetűsítés után)
+*/
+void RSA::collect_letters(const std::string& eredeti, std::vector<unsigned long long>& bases) const {
     std::string eredeti2 = toLowerCase(eredeti);
+    for (size_t i = 0; i < eredeti2.size(); ++i) {
+        if (eredeti2[i] != ' ')
+            bases.push_back(eredeti2[i] - 'a');
+    }
+}
+
+//! format_cipher függvény
+/*!
+    \param eredeti szabályos szöveg
+    \param powers a collect_letters() által gyűjtött betűk hatványai
+    \param next a szöveg első betűjének hatványa a powers-ben; a végén az utolsó utánira mutat
+    \param titkos ide írja a titkosított alakot
+
+    Minden karakterhez egy számot és egy szóközt ír: a szóköz a RSA_ALPHABET_SIZE különleges
+    értéket kapja, a betű a hatványa modulo RSA_ALPHABET_SIZE + 'a' értéket.
+*/
+void RSA::format_cipher(const std::string& eredeti, const std::vector<unsigned long long>& powers, size_t& next, std::string& titkos) const {
     for (size_t i = 0; i < eredeti.size(); ++i) {
         unsigned long long c;
-        char aktualis = eredeti2[i];
-        if (aktualis == ' ') {
+        if (eredeti[i] == ' ') {
             c = RSA_ALPHABET_SIZE; // Preserve spaces as a special value
         } else {
-            c = (modularExponentiation(aktualis - 'a', publicKey, RSA_ALPHABET_SIZE) % RSA_ALPHABET_SIZE) + 'a';
+            c = (powers[next++] % RSA_ALPHABET_SIZE) + 'a';
         }
         
         std::string cStr;
@@ -291,8 +528,6 @@ std::string RSA::encrypt(const std::string& eredeti) const {
         
         titkos += cStr + " ";
     }
-
-    return titkos;
 }
 
 //! decrypt függvény
@@ -324,11 +559,57 @@ std::string RSA::encrypt(const std::string& eredeti) const {
         ha van még token. Ehhez az endPos értékét úgy módosítja, hogy az endPos-t az aktuális 
         részleten belül adjon hozzá a startPos értékhez.
 
+    A tokeneket előbb összegyűjti, és a szabályos betű tokeneket egy menetben hatványozza
+    az exponentiateAll() segítségével; a többi token (pl. szóköz) a decrypt_token() útján megy.
+
     5. Visszaadja a decryptedText stringet, amely tartalmazza
 */
 std::string RSA::decrypt(const std::string& titkos) const {
+    std::vector<unsigned long long> tokens;
+    std::vector<unsigned long long> bases;
+    collect_tokens(titkos, tokens, bases);
+
+    std::vector<unsigned long long> powers;
+    exponentiateAll(bases, privateKey, powers);
+
     std::string decryptedText;
+    size_t next = 0;
+    format_plain(tokens, 0, tokens.size(), powers, next, decryptedText);
+    return decryptedText;
+}
 
+//! decrypt_all függvény
+/*!
+    \param secrets a visszafejtendő titkos szövegek
+    \return a visszafejtett szövegek, sorrendben
+    Ugyanazt adja, mint a decrypt() szövegenként, de az összes szöveg betű
+    tokenjeit egy exponentiateAll() hívásban hatványozza (lásd encrypt_all()).
+*/
+std::vector<std::string> RSA::decrypt_all(const std::vector<std::string>& secrets) const {
+    std::vector<unsigned long long> tokens;
+    std::vector<unsigned long long> bases;
+    std::vector<size_t> ends(secrets.size());
+    for (size_t i = 0; i < secrets.size(); ++i) {
+        collect_tokens(secrets[i], tokens, bases);
+        ends[i] = tokens.size();
+    }
+    std::vector<unsigned long long> powers;
+    exponentiateAll(bases, privateKey, powers);
+
+    std::vector<std::string> out(secrets.size());
+    size_t next = 0;
+    for (size_t i = 0; i < secrets.size(); ++i)
+        format_plain(tokens, i == 0 ? 0 : ends[i - 1], ends[i], powers, next, out[i]);
+    return out;
+}
+
+//! collect_tokens függvény
+/*!
+    \param titkos titkos szöveg (szóközzel lezárt számok)
+    \param tokens ide fűzi a tokenek számértékét
+    \param bases ide fűzi a szabályos betű tokenek 'a'-tól számolt értékét
+*/
+void RSA::collect_tokens(const std::string& titkos, std::vector<unsigned long long>& tokens, std::vector<unsigned long long>& bases) const {
     std::string token;
     size_t startPos = 0;
     size_t endPos = findSpace(titkos);
@@ -337,15 +618,9 @@ std::string RSA::decrypt(const std::string& titkos) const {
         token = titkos.substr(startPos, endPos - startPos);
 
         unsigned long long c = std::strtoull(token.c_str(), nullptr, 10);
-        unsigned long long m;
-
-        if (c == RSA_ALPHABET_SIZE) {
-            m = ' '; // Restore preserved spaces
-        } else {
-            m = (modularExponentiation(c - 'a', privateKey, RSA_ALPHABET_SIZE) % RSA_ALPHABET_SIZE) + 'a';
-        }
-
-        decryptedText += static_cast<char>(m);
+        tokens.push_back(c);
+        if (c != RSA_ALPHABET_SIZE && c - 'a' < RSA_ALPHABET_SIZE)
+            bases.push_back(c - 'a');
 
         startPos = endPos + 1;
         endPos = findSpace(titkos.substr(startPos));
@@ -353,13 +628,64 @@ std::string RSA::decrypt(const std::string& titkos) const {
             endPos += startPos;
         }
     }
+}
 
-    return decryptedText;
+//! format_plain függvény
+/*!
+    \param tokens a collect_tokens() által gyűjtött tokenek
+    \param begin az első feldolgozandó token indexe
+    \param end az utolsó utáni token indexe
+    \param powers a betű tokenek hatványai
+    \param next az első betű token hatványa a powers-ben; a végén az utolsó utánira mutat
+    \param decryptedText ide írja a visszafejtett szöveget
+    A betű tokenek a powers-ből, a többi (pl. szóköz) a decrypt_token() útján kerül a kimenetre.
+*/
+void RSA::format_plain(const std::vector<unsigned long long>& tokens, size_t begin, size_t end,
+                       const std::vector<unsigned long long>& powers, size_t& next, std::string& decryptedText) const {
+    for (size_t i = begin; i < end; ++i) {
+        unsigned long long c = tokens[i];
+        if (c != RSA_ALPHABET_SIZE && c - 'a' < RSA_ALPHABET_SIZE)
+            decryptedText += static_cast<char>((powers[next++] % RSA_ALPHABET_SIZE) + 'a');
+        else
+            decryptedText += decrypt_token(c);
+    }
 }
 
+//! decrypt_token függvény
+/*!
+    \param c egy titkosított token számértéke
+    \return a visszafejtett karakter
 
+    Ha a c értéke megegyezik a RSA_ALPHABET_SIZE-szal, akkor szóközt ad vissza,
+    különben a privateKey kitevővel hatványozza a (c - 'a') értéket a RSA_ALPHABET_SIZE modulon belül.
+    A decrypt() és a lusta visszafejtő nézet (RSADecryptView) is erre épül.
+*/
+char RSA::decrypt_token(unsigned long long c) const {
+    unsigned long long m;
 
+    if (c == RSA_ALPHABET_SIZE) {
+        m = ' '; // Restore preserved spaces
+    } else {
+        m = (modularExponentiation(c - 'a', privateKey, RSA_ALPHABET_SIZE) % RSA_ALPHABET_SIZE) + 'a';
+    }
+
+    return static_cast<char>(m);
+}
 
+//! accepts függvény
+/*!
+    \param eredeti A titkosítandó sztring
+    \return igaz, ha minden karakter angol betű vagy szóköz
+    Az encrypt() ugyanezt ellenőrzi; a hívó így kiírás és "Error" nélkül szűrheti a bemenetet.
+*/
+bool RSA::accepts(const std::string& eredeti) const {
+    for (size_t i = 0; i < eredeti.size(); ++i) {
+        unsigned char f = static_cast<unsigned char>(eredeti[i]);
+        if (!(f >= 'a' && f <= 'z') && !(f >= 'A' && f <= 'Z') && f != ' ')
+            return false;
+    }
+    return true;
+}
 
 //! get_public_key függvény
 /*!
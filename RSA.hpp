@@ -10,6 +10,8 @@
 #define RSA_HPP
 
 #include "Encryption.hpp"
+#include <atomic>
+#include <vector>
 
 //! RSA osztály
 class RSA : public Encryption {
@@ -21,6 +23,9 @@ private:
     //! privateKey változó
     unsigned long long privateKey;
 
+    //! Konstans idejű mód be van-e kapcsolva
+    bool constantTime;
+
     // generateRandomPrime függvény
     unsigned long long generateRandomPrime(unsigned long long min, unsigned long long max) const;
 
@@ -30,6 +35,31 @@ private:
     // modularExponentiation függvény
     unsigned long long modularExponentiation(unsigned long long base, unsigned long long exponent, unsigned long long modulus) const;
     
+    // windowedExponentiation függvény
+    unsigned long long windowedExponentiation(unsigned long long base, unsigned long long exponent, unsigned long long modulus, unsigned window) const;
+
+    // ladderExponentiation függvény
+    unsigned long long ladderExponentiation(unsigned long long base, unsigned long long exponent, unsigned long long modulus) const;
+
+    // exponentiateAll függvény
+    void exponentiateAll(const std::vector<unsigned long long>& bases, unsigned long long exponent, std::vector<unsigned long long>& powers) const;
+
+    // collect_letters függvény
+    void collect_letters(const std::string& eredeti, std::vector<unsigned long long>& bases) const;
+
+    // format_cipher függvény
+    void format_cipher(const std::string& eredeti, const std::vector<unsigned long long>& powers, size_t& next, std::string& titkos) const;
+
+    // collect_tokens függvény
+    void collect_tokens(const std::string& titkos, std::vector<unsigned long long>& tokens, std::vector<unsigned long long>& bases) const;
+
+    // format_plain függvény
+    void format_plain(const std::vector<unsigned long long>& tokens, size_t begin, size_t end,
+                      const std::vector<unsigned long long>& powers, size_t& next, std::string& decryptedText) const;
+
+    // A moduláris hatványozás ablakmérete (1 = bitenkénti négyzetre emelés és szorzás)
+    static std::atomic<unsigned> modexpWindow_;
+
     // modularInverse függvény
     unsigned long long modularInverse(unsigned long long a, unsigned long long m) const;
     
@@ -46,6 +76,9 @@ private:
     std::string toLowerCase(const std::string& str) const;
 
 public:
+
+    //! A legnagyobb megengedett ablakméret
+    static const unsigned MAX_MODEXP_WINDOW = 8;
     
     // Default konstruktor
     RSA();
@@ -56,11 +89,38 @@ public:
     // decrypt függvény
     std::string decrypt(const std::string& titkos) const override;
     
+    // encrypt_all függvény
+    std::vector<std::string> encrypt_all(const std::vector<std::string>& texts) const;
+
+    // decrypt_all függvény
+    std::vector<std::string> decrypt_all(const std::vector<std::string>& secrets) const;
+
+    // decrypt_token függvény
+    char decrypt_token(unsigned long long c) const;
+
     // get_public_key függvény
     std::string get_public_key() const override;
+
+    // set_constant_time függvény
+    void set_constant_time(bool enabled);
+
+    // is_constant_time függvény
+    bool is_constant_time() const;
+
+    // power függvény
+    unsigned long long power(unsigned long long base, unsigned long long exponent, unsigned long long modulus) const;
+
+    // set_modexp_window függvény
+    static bool set_modexp_window(unsigned window);
+
+    // modexp_window függvény
+    static unsigned modexp_window();
     
     // get_private_key függvény
     std::string get_private_key() const override;
+
+    // accepts függvény
+    bool accepts(const std::string& eredeti) const override;
 };
 
 #endif
@@ -0,0 +1,334 @@
+/**
+ * @file TimingHarness.cpp
+ * @author Ujhelyi Bence (ujhelyibence@gmail.com)
+ * @version 0.1
+ * @date 2023-05-15
+ *
+ * dudect-stílusú időzítés-szórás mérőprogram (make timing, ./timing [mintaszám]).
+ * Minden titkosító és visszafejtő útvonalon két bemeneti osztályt mér
+ * véletlenszerűen összekeverve: egy rögzített bemenetet és véletlen bemeneteket
+ * (visszafejtésnél ugyanazzal a kulccsal készült rögzített és véletlen titkos
+ * szövegeket). A két osztály futásidő-eloszlását Welch-féle t-próbával hasonlítja össze; |t| > 4.5 esetén
+ * a futásidő valószínűleg függ a bemenettől (szivárog). Végül összeveti a
+ * konstans idejű RSA mód áteresztőképességét a gyors úttal.
+ */
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include "RSA.hpp"
+#include "Caesar.hpp"
+
+#if (defined(__GNUC__) || defined(__clang__)) && defined(__x86_64__)
+#include <x86intrin.h>
+#define TIMING_RDTSC 1
+#endif
+
+namespace {
+
+//! A t-érték, amely felett az eltérést szivárgásnak tekintjük (a dudect küszöbe)
+const double T_THRESHOLD = 4.5;
+
+//! ticks függvény
+/*!
+    \return időbélyeg: x86-on TSC ciklus (lfence-szel sorosítva), máshol nanoszekundum
+*/
+inline unsigned long long ticks() {
+#ifdef TIMING_RDTSC
+    _mm_lfence();
+    unsigned long long t = __rdtsc();
+    _mm_lfence();
+    return t;
+#else
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+//! Welch struktúra
+/*!
+    Két osztály futásidejének online (Welford) átlaga és szórása, ebből Welch t-érték.
+*/
+struct Welch {
+    double mean[2] = {0, 0};
+    double m2[2] = {0, 0};
+    double n[2] = {0, 0};
+
+    void push(int cls, double x) {
+        n[cls] += 1;
+        double delta = x - mean[cls];
+        mean[cls] += delta / n[cls];
+        m2[cls] += delta * (x - mean[cls]);
+    }
+
+    double t() const {
+        if (n[0] < 2 || n[1] < 2)
+            return 0;
+        double var0 = m2[0] / (n[0] - 1);
+        double var1 = m2[1] / (n[1] - 1);
+        double den = std::sqrt(var0 / n[0] + var1 / n[1]);
+        return den > 0 ? (mean[0] - mean[1]) / den : 0;
+    }
+};
+
+//! Measurement struktúra
+struct Measurement {
+    double tRaw;
+    double tCropped;
+    double median[2];
+};
+
+//! measure függvény
+/*!
+    \param samples mintaszám
+    \param classes minden mintához a bemeneti osztály (0 = rögzített, 1 = véletlen)
+    \param op a mérendő művelet, paramétere a minta sorszáma
+    \return a nyers és a levágott t-érték, valamint osztályonként a medián
+
+    A bemeneteket a hívó előre elkészíti, így a mérés csak a műveletet tartalmazza.
+    A levágott t-értékhez a dudect-hez hasonlóan több percentilis (50, 75, 90, 99)
+    felett eldobja a mintákat, és a legnagyobb abszolút t-értéket adja vissza.
+*/
+template <class Op>
+Measurement measure(size_t samples, const std::vector<int>& classes, Op op) {
+    std::vector<double> times(samples);
+    for (size_t i = 0; i < samples; ++i) {
+        unsigned long long start = ticks();
+        op(i);
+        times[i] = static_cast<double>(ticks() - start);
+    }
+
+    Measurement result;
+    Welch raw;
+    std::vector<double> perClass[2];
+    for (size_t i = 0; i < samples; ++i) {
+        raw.push(classes[i], times[i]);
+        perClass[classes[i]].push_back(times[i]);
+    }
+    result.tRaw = raw.t();
+    for (int c = 0; c < 2; ++c) {
+        std::vector<double>& v = perClass[c];
+        std::nth_element(v.begin(), v.begin() + v.size() / 2, v.end());
+        result.median[c] = v.empty() ? 0 : v[v.size() / 2];
+    }
+
+    std::vector<double> sorted(times);
+    std::sort(sorted.begin(), sorted.end());
+    const double percentiles[] = {0.5, 0.75, 0.9, 0.99};
+    result.tCropped = 0;
+    for (double p : percentiles) {
+        double limit = sorted[static_cast<size_t>(p * (sorted.size() - 1))];
+        Welch cropped;
+        for (size_t i = 0; i < samples; ++i)
+            if (times[i] <= limit)
+                cropped.push(classes[i], times[i]);
+        if (std::fabs(cropped.t()) > std::fabs(result.tCropped))
+            result.tCropped = cropped.t();
+    }
+    return result;
+}
+
+//! report függvény
+void report(const std::string& name, const Measurement& m) {
+    bool leak = std::fabs(m.tRaw) > T_THRESHOLD || std::fabs(m.tCropped) > T_THRESHOLD;
+    std::cout << std::left << std::setw(34) << name << std::right
+              << std::setw(10) << std::fixed << std::setprecision(2) << m.tRaw
+              << std::setw(10) << m.tCropped
+              << std::setw(12) << std::setprecision(0) << m.median[0]
+              << std::setw(12) << m.median[1]
+              << "  " << (leak ? "SZIVAROG" : "OK") << std::endl;
+}
+
+//! seconds függvény
+/*!
+    \return az op() reps-szeri futtatásának ideje másodpercben
+*/
+template <class Op>
+double seconds(int reps, Op op) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    for (int i = 0; i < reps; ++i)
+        op();
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+//! random_letters függvény
+std::string random_letters(std::mt19937_64& rng, size_t length) {
+    std::string text(length, 'a');
+    for (char& c : text)
+        c = static_cast<char>('a' + rng() % 26);
+    return text;
+}
+
+}
+
+//! Main függvény
+/*!
+    Lefuttatja a t-próbákat minden útvonalra, majd az áteresztőképesség-összehasonlítást.
+*/
+int main(int argc, char** argv) {
+    size_t samples = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 20000;
+    if (samples < 100)
+        samples = 100;
+
+    std::mt19937_64 rng(12345);
+    std::vector<int> classes(samples);
+    for (int& c : classes)
+        c = static_cast<int>(rng() & 1);
+
+    // Az RSA::encrypt() hibás karakternél a standard kimenetre ír, ezt mérés közben elnyeljük
+    std::streambuf* stdoutBuf = std::cout.rdbuf();
+    std::ostream out(stdoutBuf);
+    std::cout.rdbuf(nullptr);
+
+    std::vector<std::pair<std::string, Measurement> > results;
+    const size_t LENGTH = 64;
+
+    // Caesar: rögzített csupa betű vs. véletlen nyomtatható ASCII
+    {
+        Caesar caesar(3);
+        std::vector<std::string> inputs(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            inputs[i] = std::string(LENGTH, 'a');
+            if (classes[i])
+                for (char& c : inputs[i])
+                    c = static_cast<char>(' ' + rng() % 95);
+        }
+        results.push_back(std::make_pair("Caesar encrypt",
+            measure(samples, classes, [&](size_t i) { caesar.encrypt(inputs[i]); })));
+
+        std::vector<std::string> secrets(samples);
+        for (size_t i = 0; i < samples; ++i)
+            secrets[i] = caesar.encrypt(inputs[i]);
+        results.push_back(std::make_pair("Caesar decrypt",
+            measure(samples, classes, [&](size_t i) { caesar.decrypt(secrets[i]); })));
+    }
+
+    // Caesar UTF-8: rögzített ASCII vs. véletlen magyar betűk (ékezetesekkel)
+    {
+        Caesar caesar(3, Caesar::HUNGARIAN_LOWER, Caesar::HUNGARIAN_UPPER);
+        const char* letters[] = {"a", "á", "e", "é", "o", "ő", "u", "ű", "s", "z"};
+        std::vector<std::string> inputs(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            for (size_t k = 0; k < LENGTH / 2; ++k)
+                inputs[i] += classes[i] ? letters[rng() % 10] : "a";
+        }
+        results.push_back(std::make_pair("Caesar UTF-8 encrypt",
+            measure(samples, classes, [&](size_t i) { caesar.encrypt(inputs[i]); })));
+
+        std::vector<std::string> secrets(samples);
+        for (size_t i = 0; i < samples; ++i)
+            secrets[i] = caesar.encrypt(inputs[i]);
+        results.push_back(std::make_pair("Caesar UTF-8 decrypt",
+            measure(samples, classes, [&](size_t i) { caesar.decrypt(secrets[i]); })));
+    }
+
+    RSA rsa;
+    RSA rsaCt;
+    rsaCt.set_constant_time(true);
+
+    // RSA encrypt hibás karakterrel: rögzített (utolsó helyen) vs. véletlen pozíció
+    {
+        std::vector<std::string> inputs(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            inputs[i] = random_letters(rng, LENGTH);
+            inputs[i][classes[i] ? rng() % LENGTH : LENGTH - 1] = '#';
+        }
+        results.push_back(std::make_pair("RSA encrypt hibas karakter",
+            measure(samples, classes, [&](size_t i) { rsa.encrypt(inputs[i]); })));
+        results.push_back(std::make_pair("RSA encrypt hibas karakter (CT)",
+            measure(samples, classes, [&](size_t i) { rsaCt.encrypt(inputs[i]); })));
+    }
+
+    // RSA encrypt: rögzített vs. véletlen betűk
+    {
+        std::vector<std::string> inputs(samples);
+        std::string fixed = random_letters(rng, LENGTH);
+        for (size_t i = 0; i < samples; ++i)
+            inputs[i] = classes[i] ? random_letters(rng, LENGTH) : fixed;
+        results.push_back(std::make_pair("RSA encrypt",
+            measure(samples, classes, [&](size_t i) { rsa.encrypt(inputs[i]); })));
+        results.push_back(std::make_pair("RSA encrypt (CT)",
+            measure(samples, classes, [&](size_t i) { rsaCt.encrypt(inputs[i]); })));
+    }
+
+    // RSA decrypt: ugyanazzal a kulccsal titkosított rögzített vs. véletlen szöveg
+    {
+        std::string fixed = random_letters(rng, LENGTH);
+        std::string fixedSecret = rsa.encrypt(fixed);
+        std::string fixedSecretCt = rsaCt.encrypt(fixed);
+        std::vector<std::string> secrets(samples), secretsCt(samples);
+        for (size_t i = 0; i < samples; ++i) {
+            if (classes[i]) {
+                std::string text = random_letters(rng, LENGTH);
+                secrets[i] = rsa.encrypt(text);
+                secretsCt[i] = rsaCt.encrypt(text);
+            } else {
+                secrets[i] = fixedSecret;
+                secretsCt[i] = fixedSecretCt;
+            }
+        }
+        results.push_back(std::make_pair("RSA decrypt",
+            measure(samples, classes, [&](size_t i) { rsa.decrypt(secrets[i]); })));
+        results.push_back(std::make_pair("RSA decrypt (CT)",
+            measure(samples, classes, [&](size_t i) { rsaCt.decrypt(secretsCt[i]); })));
+    }
+
+    // Hatványozás: rögzített (egyetlen 1-es bitű) vs. véletlen 64 bites kitevő
+    {
+        std::vector<unsigned long long> exponents(samples);
+        for (size_t i = 0; i < samples; ++i)
+            exponents[i] = classes[i] ? rng() : 1ull << 40;
+        volatile unsigned long long sink = 0;
+        results.push_back(std::make_pair("modExp kitevo",
+            measure(samples, classes, [&](size_t i) { sink = sink + rsa.power(7, exponents[i], 26); })));
+        results.push_back(std::make_pair("modExp kitevo (CT letra)",
+            measure(samples, classes, [&](size_t i) { sink = sink + rsaCt.power(7, exponents[i], 26); })));
+    }
+
+    std::cout.rdbuf(stdoutBuf);
+    std::cout.clear();
+
+    out << "=== Idozites szoras (" << samples << " minta utvonalankent, |t| > "
+        << T_THRESHOLD << " = szivarog) ===" << std::endl << std::endl;
+    out << std::left << std::setw(34) << "utvonal" << std::right << std::setw(10) << "t"
+        << std::setw(10) << "t vagott" << std::setw(12) << "median fix" << std::setw(12)
+        << "median rand" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i)
+        report(results[i].first, results[i].second);
+
+    // Áteresztőképesség: gyors út vs. konstans idejű mód
+    std::string text = random_letters(rng, 4096);
+    std::string secretFast = rsa.encrypt(text);
+    std::string secretCt = rsaCt.encrypt(text);
+    volatile unsigned long long sink = 0;
+    const int reps = 50;
+    const int powReps = 200000;
+
+    double encFast = seconds(reps, [&] { rsa.encrypt(text); });
+    double encCt = seconds(reps, [&] { rsaCt.encrypt(text); });
+    double decFast = seconds(reps, [&] { rsa.decrypt(secretFast); });
+    double decCt = seconds(reps, [&] { rsaCt.decrypt(secretCt); });
+    double powFast = seconds(powReps, [&] { sink = sink + rsa.power(sink % 26, 0xFFFFFFFFull, 26); });
+    double powCt = seconds(powReps, [&] { sink = sink + rsaCt.power(sink % 26, 0xFFFFFFFFull, 26); });
+
+    out << std::endl << "=== Ateresztokepesseg: gyors ut vs. konstans ideju mod ===" << std::endl << std::endl;
+    out << std::left << std::setw(20) << "muvelet" << std::right << std::setw(16) << "gyors"
+        << std::setw(16) << "CT" << std::setw(12) << "lassulas" << std::endl;
+    out << std::fixed << std::setprecision(2);
+    double mb = static_cast<double>(text.size()) * reps / 1e6;
+    out << std::left << std::setw(20) << "RSA encrypt" << std::right << std::setw(12) << mb / encFast << " MB/s"
+        << std::setw(12) << mb / encCt << " MB/s" << std::setw(11) << encCt / encFast << "x" << std::endl;
+    out << std::left << std::setw(20) << "RSA decrypt" << std::right << std::setw(12) << mb / decFast << " MB/s"
+        << std::setw(12) << mb / decCt << " MB/s" << std::setw(11) << decCt / decFast << "x" << std::endl;
+    out << std::left << std::setw(20) << "modExp (32 bit)" << std::right << std::setw(12) << powReps / powFast / 1e6 << " M/s "
+        << std::setw(12) << powReps / powCt / 1e6 << " M/s " << std::setw(11) << powCt / powFast << "x" << std::endl;
+
+    return 0;
+}
@@ -7,9 +7,19 @@
 
 #include <iostream>
 #include <string>
+#include <cstring>
+#include <vector>
 #include "Encryption.hpp"
 #include "RSA.hpp"
 #include "Caesar.hpp"
+#include "ChunkedContainer.hpp"
+#include "DecryptView.hpp"
+#include "EncryptionC.h"
+#include "Autotuner.hpp"
+#include "ModExpBatch.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <algorithm>
 
 //! Main függvény
 /*!
@@ -18,6 +28,14 @@
 
 int main() {
 
+    //Gépre hangolt beállítások betöltése (első futáskor kalibrálás)
+    bool calibrated = false;
+    TuningConfig tuning = Autotuner::initialize(&calibrated);
+    std::cout << "Hangolas (" << (calibrated ? "kalibralva" : "cache") << "): kernel="
+              << Autotuner::kernel_name(tuning.asciiKernel) << " darab=" << tuning.chunkSize
+              << " szal=" << tuning.threads << " ablak=" << tuning.modexpWindow
+              << " hatvanyozas=" << Autotuner::kernel_name(tuning.modexpKernel) << std::endl;
+
     //RSA algoritmus tesztelése
     std::cout <<std::endl<< "=== RSA Algoritmus Teszt ===" << std::endl<<std::endl;
     int n = 0;
@@ -162,6 +180,366 @@ int main() {
     
     std::cout << "SIKERES: "<<count<<"/3"<<std::endl;
 
+    std::cout<<std::endl;
+
+    //UTF-8 Caesar tesztelése
+    std::cout << "=== Caesar UTF-8 Teszt ===" << std::endl<<std::endl;
+    try{
+        Caesar caesar(1, Caesar::HUNGARIAN_LOWER, Caesar::HUNGARIAN_UPPER);
+        std::string text = "Árvíztűrő tükörfúrógép, zúzmara az Őrségben!";
+        std::string encrypted = caesar.encrypt(text);
+        std::cout << "Eredeti: " << text << std::endl;
+        std::cout << "Titkosított: " << encrypted << std::endl;
+        std::string decrypted = caesar.decrypt(encrypted);
+        std::cout << "Visszafejtett: " << decrypted << std::endl;
+        if (decrypted == text && caesar.encrypt("a\xC3z") == "\xC3\xA1" "\xC3" "a") {
+            std::cout << "SIKERES 1/1" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 1/1" << std::endl;
+        }
+    }
+    catch(std::exception& e){
+        std::cerr << "HIBA:  " << e.what() << std::endl;
+    }
+
+    std::cout<<std::endl;
+
+    //Lusta visszafejtő nézetek tesztelése
+    std::cout << "=== Lusta Visszafejtes Teszt ===" << std::endl<<std::endl;
+    try{
+        RSA rsa;
+        std::string rsaTitkos = rsa.encrypt("weores sandor");
+        std::string rsaTeljes = rsa.decrypt(rsaTitkos);
+        RSADecryptView rsaView(rsa, rsaTitkos);
+        std::string rsaLusta(rsaView.begin(), rsaView.end());
+        RSADecryptView::iterator space = std::find(rsaView.begin(), rsaView.end(), ' ');
+        std::cout << "Elso szo utan: " << std::string(space, rsaView.end()) << std::endl;
+        if (rsaLusta == rsaTeljes && space != rsaView.end()) {
+            std::cout << "SIKERES 1/2" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 1/2" << std::endl;
+        }
+
+        Caesar caesar(5, Caesar::HUNGARIAN_LOWER, Caesar::HUNGARIAN_UPPER);
+        std::string text = "Őszi éjjel izzik a galagonya";
+        std::string caesarTitkos = caesar.encrypt(text);
+        CaesarDecryptView caesarView(caesar, caesarTitkos);
+        std::string prefix = "Őszi";
+        if (std::equal(prefix.begin(), prefix.end(), caesarView.begin())
+            && std::string(caesarView.begin(), caesarView.end()) == text) {
+            std::cout << "SIKERES 2/2" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 2/2" << std::endl;
+        }
+    }
+    catch(std::exception& e){
+        std::cerr << "HIBA:  " << e.what() << std::endl;
+    }
+
+    std::cout<<std::endl;
+
+    //C ABI tesztelése
+    std::cout << "=== C ABI Teszt ===" << std::endl<<std::endl;
+    {
+        // a hangolás folyamatonként egyszer fut (itt már a main elején lefutott egyszer, cache-ből)
+        int32_t elsoKalibralt = -1, masodikKalibralt = -1;
+        bool hangolas = enc_autotune_initialize(&elsoKalibralt) == ENC_OK
+            && enc_autotune_initialize(&masodikKalibralt) == ENC_OK && masodikKalibralt == 0;
+        enc_cipher* cipher = nullptr;
+        enc_caesar_new(2, &cipher);
+        char kimenet1[16], kimenet2[16];
+        enc_input bemenet[2] = {{"fak", 3}, {"zold", 4}};
+        enc_output kimenet[2] = {{kimenet1, sizeof kimenet1, 0, 0}, {kimenet2, 2, 0, 0}};
+        enc_status status = enc_encrypt_batch(cipher, bemenet, kimenet, 2);
+        std::cout << "Kotegelt: " << std::string(kimenet1, kimenet[0].len) << ", "
+                  << enc_status_message(kimenet[1].status) << std::endl;
+        if (status == ENC_ERR_BUFFER_TOO_SMALL && std::string(kimenet1, kimenet[0].len) == "hcm"
+            && kimenet[1].len == 4 && enc_encrypt(nullptr, "a", 1, kimenet1, 16, &kimenet[0].len) == ENC_ERR_NULL_POINTER
+            && hangolas) {
+            std::cout << "SIKERES 1/3" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 1/3" << std::endl;
+        }
+        enc_free(cipher);
+
+        // UTF-8 mód: a kimenet közvetlenül a hívó pufferébe kerül, pontos méretnél is
+        std::string lower = Caesar::HUNGARIAN_LOWER, upper = Caesar::HUNGARIAN_UPPER;
+        Caesar caesar(3, lower, upper);
+        std::string text = "\xC3\xA1rv\xC3\xADzt\xC5\xB1r\xC5\x91 t\xC3\xBCk\xC3\xB6rf\xC3\xBAr\xC3\xB3g\xC3\xA9p";
+        std::string elvart = caesar.encrypt(text);
+        enc_caesar_new_utf8(3, lower.data(), lower.size(), upper.data(), upper.size(), &cipher);
+        std::string puffer(elvart.size(), '\0');
+        size_t hossz = 0;
+        enc_status kicsi = enc_encrypt(cipher, text.data(), text.size(), &puffer[0], puffer.size() - 1, &hossz);
+        bool kicsiJo = kicsi == ENC_ERR_BUFFER_TOO_SMALL && hossz == elvart.size();
+        enc_status pontos = enc_encrypt(cipher, text.data(), text.size(), &puffer[0], puffer.size(), &hossz);
+        std::string vissza(text.size(), '\0');
+        size_t visszaHossz = 0;
+        enc_decrypt(cipher, puffer.data(), hossz, &vissza[0], vissza.size(), &visszaHossz);
+        if (kicsiJo && pontos == ENC_OK && puffer == elvart && std::string(vissza, 0, visszaHossz) == text) {
+            std::cout << "SIKERES 2/3" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 2/3" << std::endl;
+        }
+        enc_free(cipher);
+
+        // szélsőséges eltolás: a visszafejtés sem csordulhat túl
+        bool szelso = true;
+        for (int utf8 = 0; utf8 < 2; ++utf8) {
+            if (utf8)
+                enc_caesar_new_utf8(INT32_MIN, lower.data(), lower.size(), upper.data(), upper.size(), &cipher);
+            else
+                enc_caesar_new(INT32_MIN, &cipher);
+            std::string titkos(4 * text.size(), '\0'), nyilt(text.size(), '\0');
+            size_t titkosHossz = 0, nyiltHossz = 0;
+            szelso = szelso
+                && enc_encrypt(cipher, text.data(), text.size(), &titkos[0], titkos.size(), &titkosHossz) == ENC_OK
+                && enc_decrypt(cipher, titkos.data(), titkosHossz, &nyilt[0], nyilt.size(), &nyiltHossz) == ENC_OK
+                && std::string(nyilt, 0, nyiltHossz) == text;
+            enc_free(cipher);
+        }
+        std::cout << (szelso ? "SIKERES 3/3" : "SIKERTELEN 3/3") << std::endl;
+    }
+
+    std::cout<<std::endl;
+
+    //Hangolás tesztelése
+    std::cout << "=== Hangolas Teszt ===" << std::endl<<std::endl;
+    {
+        std::string path = "autotuner_teszt.cfg";
+        TuningConfig config = Autotuner::defaults();
+        config.chunkSize = 12345;
+        config.modexpWindow = 4;
+        config.modexpKernel = ModExpBatch::KERNEL_SCALAR;
+        TuningConfig loaded = Autotuner::defaults();
+        bool roundTrip = Autotuner::save(path, config) && Autotuner::load(path, loaded)
+            && loaded.chunkSize == 12345 && loaded.modexpWindow == 4
+            && loaded.modexpKernel == ModExpBatch::KERNEL_SCALAR;
+        std::remove(path.c_str());
+
+        setenv("ENCRYPTION_THREADS", "3", 1);
+        setenv("ENCRYPTION_MODEXP_KERNEL", "avx2", 1);
+        Autotuner::apply_env(loaded);
+        unsetenv("ENCRYPTION_THREADS");
+        unsetenv("ENCRYPTION_MODEXP_KERNEL");
+        bool kernelOk = ModExpBatch::kernel_supported(ModExpBatch::KERNEL_AVX2)
+            ? loaded.modexpKernel == ModExpBatch::KERNEL_AVX2
+            : loaded.modexpKernel == ModExpBatch::KERNEL_SCALAR;
+        // a kalibráció után az automatikus (0) szálszám megmarad
+        ChunkedContainer::set_default_threads(0);
+        Autotuner::calibrate();
+        bool autoThreads = ChunkedContainer::default_threads() == 0;
+        ChunkedContainer::set_default_threads(tuning.threads);
+        if (roundTrip && loaded.threads == 3 && kernelOk && autoThreads) {
+            std::cout << "SIKERES 1/1" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 1/1" << std::endl;
+        }
+    }
+
+    std::cout<<std::endl;
+
+    //Kötegelt hatványozás tesztelése
+    std::cout << "=== Kotegelt Hatvanyozas Teszt ===" << std::endl<<std::endl;
+    {
+        RSA rsa;
+        std::string text = "a csokod festi kekre az eget szemed szinetol zoldulnek a fak";
+        ModExpBatch::Kernel eredeti = ModExpBatch::kernel();
+        ModExpBatch::set_kernel(ModExpBatch::KERNEL_SCALAR);
+        std::string skalar = rsa.encrypt(text);
+        std::string skalarVissza = rsa.decrypt(skalar);
+        bool egyezik = true;
+        const ModExpBatch::Kernel kernelek[] = {ModExpBatch::KERNEL_AVX2, ModExpBatch::KERNEL_AVX512};
+        for (ModExpBatch::Kernel kernel : kernelek) {
+            if (ModExpBatch::set_kernel(kernel)) {
+                std::cout << "Kernel " << kernel << " tamogatott" << std::endl;
+                egyezik = egyezik && rsa.encrypt(text) == skalar
+                    && rsa.decrypt(skalar) == skalarVissza;
+            }
+        }
+        ModExpBatch::set_kernel(eredeti);
+
+        unsigned long long alapok[11], kitevok[11], eredmeny[11];
+        for (int i = 0; i < 11; ++i) {
+            alapok[i] = 1000 + 37 * i;
+            kitevok[i] = 65537 + 1000 * i;
+        }
+        ModExpBatch::compute(alapok, kitevok, 999983, eredmeny, 11);
+        for (int i = 0; i < 11; ++i) {
+            unsigned long long elvart = 1, alap = alapok[i] % 999983;
+            for (unsigned long long e = kitevok[i]; e > 0; e /= 2) {
+                if (e % 2 == 1) elvart = elvart * alap % 999983;
+                alap = alap * alap % 999983;
+            }
+            egyezik = egyezik && eredmeny[i] == elvart;
+        }
+        if (egyezik) {
+            std::cout << "SIKERES 1/2" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 1/2" << std::endl;
+        }
+
+        // sok rövid üzenet a C ABI kötegelt hívásán: egy menetben hatványoz, az eredmény
+        // elemenként ugyanaz, mint az egyenkénti hívásé; a hibás elem a többit nem rontja el
+        enc_cipher* cipher = nullptr;
+        enc_rsa_new(&cipher);
+        const char* uzenetek[] = {"fa", "ko", "ég", "to", "ut", "Ar", "sz", "hid", "el", "jo", "ma", "ne", "ok", "ha", "be", "le"};
+        const size_t DARAB = sizeof uzenetek / sizeof uzenetek[0];
+        std::vector<enc_input> bemenet(DARAB);
+        std::vector<enc_output> kimenet(DARAB);
+        std::vector<std::string> puffer(DARAB, std::string(32, '\0'));
+        for (size_t i = 0; i < DARAB; ++i) {
+            bemenet[i].data = uzenetek[i];
+            bemenet[i].len = std::strlen(uzenetek[i]);
+            kimenet[i].data = &puffer[i][0];
+            kimenet[i].cap = puffer[i].size();
+        }
+        enc_status status = enc_encrypt_batch(cipher, bemenet.data(), kimenet.data(), DARAB);
+        bool kotegJo = status == ENC_ERR_INVALID_INPUT && kimenet[2].status == ENC_ERR_INVALID_INPUT;
+        std::vector<enc_input> titkos(DARAB);
+        std::vector<enc_output> vissza(DARAB);
+        std::vector<std::string> visszaPuffer(DARAB, std::string(32, '\0'));
+        for (size_t i = 0; i < DARAB; ++i) {
+            if (i == 2)
+                continue;
+            char egyes[32];
+            size_t hossz = 0;
+            enc_encrypt(cipher, bemenet[i].data, bemenet[i].len, egyes, sizeof egyes, &hossz);
+            kotegJo = kotegJo && kimenet[i].status == ENC_OK
+                && std::string(kimenet[i].data, kimenet[i].len) == std::string(egyes, hossz);
+            titkos[i].data = kimenet[i].data;
+            titkos[i].len = kimenet[i].len;
+            vissza[i].data = &visszaPuffer[i][0];
+            vissza[i].cap = visszaPuffer[i].size();
+        }
+        titkos[2].data = "97 ";
+        titkos[2].len = 3;
+        vissza[2].data = &visszaPuffer[2][0];
+        vissza[2].cap = visszaPuffer[2].size();
+        kotegJo = kotegJo && enc_decrypt_batch(cipher, titkos.data(), vissza.data(), DARAB) == ENC_OK;
+        for (size_t i = 0; i < DARAB; ++i) {
+            char egyes[32];
+            size_t hossz = 0;
+            enc_decrypt(cipher, titkos[i].data, titkos[i].len, egyes, sizeof egyes, &hossz);
+            kotegJo = kotegJo && std::string(vissza[i].data, vissza[i].len) == std::string(egyes, hossz);
+        }
+        enc_free(cipher);
+        if (kotegJo) {
+            std::cout << "SIKERES 2/2" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 2/2" << std::endl;
+        }
+    }
+
+    std::cout<<std::endl;
+
+    //Konstans idejű mód tesztelése
+    std::cout << "=== Konstans Ideju Mod Teszt ===" << std::endl<<std::endl;
+    {
+        RSA rsa;
+        std::string text = "szemed szinetol zoldulnek a fak";
+        std::string gyors = rsa.encrypt(text);
+        std::string gyorsVissza = rsa.decrypt(gyors);
+        rsa.set_constant_time(true);
+        std::string ct = rsa.encrypt(text);
+        std::cout << "Titkosított (CT): " << ct << std::endl;
+        bool egyezik = ct == gyors && rsa.decrypt(ct) == gyorsVissza && rsa.encrypt("hibas#") == "Error";
+        unsigned long long letra = rsa.power(7, 1234567, 999983);
+        rsa.set_constant_time(false);
+        if (egyezik && letra == rsa.power(7, 1234567, 999983)) {
+            std::cout << "SIKERES 1/1" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 1/1" << std::endl;
+        }
+    }
+
+    std::cout<<std::endl;
+
+    //Darabolt tároló tesztelése
+    std::cout << "=== Darabolt Tarolo Teszt ===" << std::endl<<std::endl;
+    try{
+        Caesar caesar(3);
+        ChunkedContainer tarolo(caesar, 7);
+        std::string text = "Lement a nap a nagy pusztan, vegig rajta alkony pir lepett.";
+        std::string container = tarolo.encrypt(text);
+        std::cout << "Darabok: " << ChunkedContainer::chunk_count(container) << std::endl;
+        std::string range = tarolo.decrypt_range(container, 9, 20);
+        std::cout << "Tartomany [9, 29): " << range << std::endl;
+        if (range == text.substr(9, 20) && tarolo.decrypt(container) == text
+            && tarolo.decrypt_parallel(container, 3) == text) {
+            std::cout << "SIKERES 1/4" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 1/4" << std::endl;
+        }
+
+        RSA rsa;
+        ChunkedContainer rsaTarolo(rsa, 4);
+        std::string rsaText = "weores sandor";
+        std::string rsaContainer = rsaTarolo.encrypt(rsaText);
+        bool elutasit = false;
+        try{
+            rsaTarolo.encrypt("weores#sandor");
+        }
+        catch(std::invalid_argument& e){
+            std::cout << "Hibas darab: " << e.what() << std::endl;
+            elutasit = true;
+        }
+        rsaContainer[30] ^= 1;
+        try{
+            rsaTarolo.decrypt(rsaContainer);
+            std::cout << "SIKERTELEN 2/4" << std::endl;
+        }
+        catch(std::runtime_error& e){
+            std::cout << "Serult darab: " << e.what() << std::endl;
+            std::cout << (elutasit ? "SIKERES 2/4" : "SIKERTELEN 2/4") << std::endl;
+        }
+
+        ChunkedContainer kisTarolo(caesar, 2);
+        std::string hamis = kisTarolo.encrypt("");
+        for (int i = 16; i < 24; ++i)
+            hamis[i] = static_cast<char>(0xFF);
+        std::string csonka = container.substr(0, container.size() - 5);
+        int elutasitva = 0;
+        try{
+            kisTarolo.decrypt_range(hamis, 0, 10);
+        }
+        catch(std::runtime_error& e){
+            std::cout << "Hamis fejlec: " << e.what() << std::endl;
+            elutasitva++;
+        }
+        try{
+            tarolo.decrypt_range(csonka, 0, 10);
+        }
+        catch(std::runtime_error& e){
+            std::cout << "Csonka tarolo: " << e.what() << std::endl;
+            elutasitva++;
+        }
+        if (elutasitva == 2) {
+            std::cout << "SIKERES 3/4" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 3/4" << std::endl;
+        }
+
+        // UTF-8: a darabhatárra eső többbájtos betű nem vágódhat ketté
+        Caesar magyar(3, Caesar::HUNGARIAN_LOWER, Caesar::HUNGARIAN_UPPER);
+        ChunkedContainer magyarTarolo(magyar, 7);
+        std::string magyarText = "aaaaaa\xC5\x91" "aaaaa\xC3\xA1\xC3\xA9 vege";
+        std::string magyarContainer = magyarTarolo.encrypt(magyarText);
+        bool nyers = magyarContainer.find("\xC5\x91") != std::string::npos
+            || magyarContainer.find("\xC3\xA1") != std::string::npos;
+        if (!nyers && magyarTarolo.decrypt(magyarContainer) == magyarText
+            && magyarTarolo.decrypt_range(magyarContainer, 6, 8) == magyarText.substr(6, 8)
+            && magyarTarolo.decrypt_range(magyarContainer, 7, 1) == magyarText.substr(7, 1)
+            && magyarTarolo.decrypt_parallel(magyarContainer, 2) == magyarText) {
+            std::cout << "SIKERES 4/4" << std::endl;
+        } else {
+            std::cout << "SIKERTELEN 4/4" << std::endl;
+        }
+    }
+    catch(std::exception& e){
+        std::cerr << "HIBA:  " << e.what() << std::endl;
+    }
+
 
     return 0;
 }